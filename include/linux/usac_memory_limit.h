@@ -0,0 +1,24 @@
+#ifndef _LINUX_USAC_MEMORY_LIMIT_H
+#define _LINUX_USAC_MEMORY_LIMIT_H
+
+/*
+ * Punto de enganche de los límites de memoria del proyecto 3 (syscalls 557-560).
+ *
+ * Los caminos que reservan memoria para un proceso (vm_mmap, brk y tamalloc)
+ * llaman a usac_memlimit_charge() antes de crear el mapeo. Si el proceso, o
+ * el grupo al que pertenece, excede su límite se retorna -ENOMEM y el llamador
+ * debe abortar la reserva.
+ *
+ * Según la política del límite la llamada puede dormir (recuperación de
+ * páginas o retraso por MEMLIMIT_THROTTLE), así que debe hacerse sin tener
+ * tomado mmap_lock.
+ */
+enum usac_memlimit_site {
+    USAC_MEMLIMIT_SITE_MMAP,
+    USAC_MEMLIMIT_SITE_BRK,
+    USAC_MEMLIMIT_SITE_TAMALLOC,
+};
+
+int usac_memlimit_charge(unsigned long bytes, enum usac_memlimit_site site);
+
+#endif /* _LINUX_USAC_MEMORY_LIMIT_H */
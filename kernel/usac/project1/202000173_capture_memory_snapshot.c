@@ -5,18 +5,10 @@
 #include <linux/uaccess.h>
 #include <linux/string.h>
 
-struct memory_snapshot {
-    unsigned long total_ram;
-    unsigned long free_ram;
-    unsigned long swap_total;
-    unsigned long swap_free;
-    unsigned long cache_ram;
-    unsigned long buffer_ram;
-    unsigned long active_ram;
-    unsigned long inactive_ram;
-};
+#include "202000173_metrics.h"
 
-static void fill_memory_snapshot(struct memory_snapshot *snap) {
+// Llena el snapshot (en páginas); también lo usan los recolectores de 202000173_metrics.c
+void usac_fill_memory_snapshot(struct memory_snapshot *snap) {
     struct sysinfo i;
     unsigned long file_pages, shmem, bufferram;
     unsigned long active_file, active_anon;
@@ -59,7 +51,7 @@ SYSCALL_DEFINE1(_202000173_capture_memory_snapshot, struct memory_snapshot __use
     struct memory_snapshot snap;
 
     // Llenar la estructura de snapshot de memoria
-    fill_memory_snapshot(&snap);
+    usac_fill_memory_snapshot(&snap);
 
     if (copy_to_user(user_snap, &snap, sizeof(snap)))
         return -EFAULT;
@@ -0,0 +1,250 @@
+#include <linux/mm.h>
+#include <linux/mmzone.h>
+#include <linux/vmstat.h>
+#include <linux/vm_event_item.h>
+#include <linux/cpu.h>
+#include <linux/psi.h>
+#include <linux/ktime.h>
+#include <linux/spinlock.h>
+#include <linux/math64.h>
+#include <linux/syscalls.h>
+#include <linux/uaccess.h>
+#include <linux/string.h>
+#include <linux/slab.h>
+#include <linux/nodemask.h>
+
+#include "202000173_metrics.h"
+
+// PSI guarda los promedios en punto fijo (FSHIFT bits) y ya en porcentaje
+#define PSI_AVG_TO_BP(avg) ((u32)(((u64)(avg) * 100) >> FSHIFT))
+
+/*
+ * Presión de memoria del sistema. Los promedios los actualiza el trabajo
+ * periódico de PSI mientras hay actividad; los totales siempre están al día.
+ */
+static void fill_memory_pressure(struct memory_snapshot_v2 *snap)
+{
+#ifdef CONFIG_PSI
+    struct psi_group *group = &psi_system;
+
+    if (static_branch_likely(&psi_disabled))
+        return;
+
+    snap->psi_some_avg10    = PSI_AVG_TO_BP(group->avg[PSI_MEM_SOME][0]);
+    snap->psi_some_avg60    = PSI_AVG_TO_BP(group->avg[PSI_MEM_SOME][1]);
+    snap->psi_some_avg300   = PSI_AVG_TO_BP(group->avg[PSI_MEM_SOME][2]);
+    snap->psi_full_avg10    = PSI_AVG_TO_BP(group->avg[PSI_MEM_FULL][0]);
+    snap->psi_full_avg60    = PSI_AVG_TO_BP(group->avg[PSI_MEM_FULL][1]);
+    snap->psi_full_avg300   = PSI_AVG_TO_BP(group->avg[PSI_MEM_FULL][2]);
+    snap->psi_some_total_us = div_u64(group->total[PSI_AVGS][PSI_MEM_SOME], NSEC_PER_USEC);
+    snap->psi_full_total_us = div_u64(group->total[PSI_AVGS][PSI_MEM_FULL], NSEC_PER_USEC);
+#endif
+}
+
+/*
+ * Suma solo los eventos que se necesitan en una pasada por las CPUs en línea,
+ * en vez de llenar con all_vm_events() el arreglo completo de /proc/vmstat.
+ */
+static void fill_reclaim_events(struct memory_snapshot_v2 *snap)
+{
+#ifdef CONFIG_VM_EVENT_COUNTERS
+    int cpu;
+
+    cpus_read_lock();
+    for_each_online_cpu(cpu) {
+        const unsigned long *ev = per_cpu(vm_event_states, cpu).event;
+
+        snap->pgscan     += ev[PGSCAN_KSWAPD] + ev[PGSCAN_DIRECT] + ev[PGSCAN_KHUGEPAGED];
+        snap->pgsteal    += ev[PGSTEAL_KSWAPD] + ev[PGSTEAL_DIRECT] + ev[PGSTEAL_KHUGEPAGED];
+        snap->pgfault    += ev[PGFAULT];
+        snap->pgmajfault += ev[PGMAJFAULT];
+        snap->pswpin     += ev[PSWPIN];
+        snap->pswpout    += ev[PSWPOUT];
+#ifdef CONFIG_COMPACTION
+        snap->compact_stall   += ev[COMPACTSTALL];
+        snap->compact_fail    += ev[COMPACTFAIL];
+        snap->compact_success += ev[COMPACTSUCCESS];
+#endif
+    }
+    cpus_read_unlock();
+#endif
+}
+
+/*
+ * Tasas de swap. Se guardan las dos últimas muestras separadas por al menos
+ * un segundo, así que llamadas muy seguidas reciben la misma tasa en vez de
+ * una calculada sobre unos pocos microsegundos.
+ */
+struct swap_rate_sample {
+    u64 time_ns;
+    u64 pswpin;
+    u64 pswpout;
+};
+
+static struct swap_rate_sample swap_rate_prev, swap_rate_last;
+static DEFINE_SPINLOCK(swap_rate_lock);
+
+static void fill_swap_rates(struct memory_snapshot_v2 *snap)
+{
+    u64 window;
+
+    spin_lock(&swap_rate_lock);
+    if (snap->timestamp_ns - swap_rate_last.time_ns >= NSEC_PER_SEC) {
+        swap_rate_prev = swap_rate_last;
+        swap_rate_last.time_ns = snap->timestamp_ns;
+        swap_rate_last.pswpin  = snap->pswpin;
+        swap_rate_last.pswpout = snap->pswpout;
+    }
+
+    // La primera ventana no tiene muestra previa y reporta 0
+    if (swap_rate_prev.time_ns) {
+        window = swap_rate_last.time_ns - swap_rate_prev.time_ns;
+        snap->pswpin_rate  = div64_u64((swap_rate_last.pswpin - swap_rate_prev.pswpin) * NSEC_PER_SEC,
+                                       window);
+        snap->pswpout_rate = div64_u64((swap_rate_last.pswpout - swap_rate_prev.pswpout) * NSEC_PER_SEC,
+                                       window);
+    }
+    spin_unlock(&swap_rate_lock);
+}
+
+void usac_fill_memory_snapshot_v2(struct memory_snapshot_v2 *snap)
+{
+    struct memory_snapshot v1;
+
+    memset(snap, 0, sizeof(*snap));
+    snap->version = MEMORY_SNAPSHOT_V2_VERSION;
+    snap->size = sizeof(*snap);
+    snap->timestamp_ns = ktime_get_ns();
+
+    // Los campos del v1 salen del mismo llenado que la syscall 548
+    usac_fill_memory_snapshot(&v1);
+    snap->total_ram    = v1.total_ram;
+    snap->free_ram     = v1.free_ram;
+    snap->swap_total   = v1.swap_total;
+    snap->swap_free    = v1.swap_free;
+    snap->cache_ram    = v1.cache_ram;
+    snap->buffer_ram   = v1.buffer_ram;
+    snap->active_ram   = v1.active_ram;
+    snap->inactive_ram = v1.inactive_ram;
+
+    fill_memory_pressure(snap);
+    fill_reclaim_events(snap);
+    fill_swap_rates(snap);
+}
+
+static unsigned int count_populated_zones(void)
+{
+    struct zone *zone;
+    unsigned int count = 0;
+
+    for_each_populated_zone(zone)
+        count++;
+    return count;
+}
+
+/*
+ * Índice de fragmentación con la misma fórmula que __fragmentation_index()
+ * de mm/vmstat.c, pero sobre los nr_free ya leídos: todos los órdenes de la
+ * zona salen de la misma lectura en lugar de recorrer free_area una vez por orden.
+ */
+static void fill_frag_index(struct memory_zone_frag *frag)
+{
+    u64 blocks_total = 0, free_pages = 0, suitable, requested;
+    unsigned int order, o;
+
+    for (order = 0; order < frag->nr_orders; order++) {
+        blocks_total += frag->nr_free[order];
+        free_pages   += frag->nr_free[order] << order;
+    }
+
+    for (order = 0; order < frag->nr_orders; order++) {
+        suitable = 0;
+        for (o = order; o < frag->nr_orders; o++)
+            suitable += frag->nr_free[o] << (o - order);
+
+        requested = 1ULL << order;
+        if (!blocks_total)
+            frag->frag_index[order] = 0;
+        else if (suitable)
+            frag->frag_index[order] = -1000;
+        else
+            frag->frag_index[order] = 1000 - div64_u64(1000 + div64_u64(free_pages * 1000, requested),
+                                                       blocks_total);
+    }
+}
+
+/*
+ * Lee los contadores de bloques libres sin tomar zone->lock. Son valores
+ * que el allocator mantiene al día en cada operación; una lectura sin lock
+ * puede mezclar órdenes de instantes apenas distintos, lo que no importa para
+ * muestrear cada segundo y evita competir con el allocator por el lock.
+ */
+static unsigned int fill_zone_frag(struct memory_zone_frag *frags, unsigned int max_zones)
+{
+    struct memory_zone_frag *frag;
+    struct zone *zone;
+    unsigned int n = 0, order;
+
+    for_each_populated_zone(zone) {
+        if (n >= max_zones)
+            break;
+
+        frag = &frags[n++];
+        memset(frag, 0, sizeof(*frag));
+        frag->node = zone_to_nid(zone);
+        frag->zone_idx = zone_idx(zone);
+        strscpy(frag->zone_name, zone->name, sizeof(frag->zone_name));
+        frag->nr_orders = min(MAX_ORDER + 1, MEMORY_FRAG_MAX_ORDERS);
+        frag->managed_pages = zone_managed_pages(zone);
+        frag->free_pages = zone_page_state(zone, NR_FREE_PAGES);
+
+        for (order = 0; order < frag->nr_orders; order++)
+            frag->nr_free[order] = READ_ONCE(zone->free_area[order].nr_free);
+        fill_frag_index(frag);
+    }
+    return n;
+}
+
+/*
+ * Syscall: _202000173_capture_memory_snapshot_v2
+ *
+ * Copia min(size, sizeof(struct memory_snapshot_v2)) bytes del snapshot.
+ * snap.size indica cuántos llenó el kernel, para que un programa compilado
+ * con una versión más nueva de la estructura sepa qué campos son válidos.
+ *
+ * Sección opcional: si zones no es NULL se copian hasta max_zones entradas
+ * de fragmentación, una por zona poblada.
+ *
+ * Retorno: cantidad de zonas pobladas del sistema (puede ser mayor que
+ * max_zones, para que el llamador sepa cuánto reservar), o un error.
+ */
+SYSCALL_DEFINE4(_202000173_capture_memory_snapshot_v2, struct memory_snapshot_v2 __user *, user_snap,
+                size_t, size, struct memory_zone_frag __user *, zones, unsigned int, max_zones)
+{
+    struct memory_snapshot_v2 snap;
+    struct memory_zone_frag *frags = NULL;
+    unsigned int nr_zones, filled = 0;
+    long ret;
+
+    if (size < offsetofend(struct memory_snapshot_v2, timestamp_ns))
+        return -EINVAL;
+
+    nr_zones = count_populated_zones();
+    if (zones && max_zones) {
+        frags = kmalloc_array(min(max_zones, nr_zones), sizeof(*frags), GFP_KERNEL);
+        if (!frags)
+            return -ENOMEM;
+    }
+
+    usac_fill_memory_snapshot_v2(&snap);
+    if (frags)
+        filled = fill_zone_frag(frags, min(max_zones, nr_zones));
+
+    ret = nr_zones;
+    if (copy_to_user(user_snap, &snap, min(size, sizeof(snap))) ||
+        (filled && copy_to_user(zones, frags, filled * sizeof(*frags))))
+        ret = -EFAULT;
+
+    kfree(frags);
+    return ret;
+}
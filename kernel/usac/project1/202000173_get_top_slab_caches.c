@@ -0,0 +1,115 @@
+#include <linux/kernel.h>
+#include <linux/syscalls.h>
+#include <linux/uaccess.h>
+#include <linux/slab.h>
+#include <linux/mutex.h>
+#include <linux/string.h>
+#include <linux/errno.h>
+#include <linux/capability.h>   // capable, CAP_SYS_ADMIN
+
+#include "../../../mm/slab.h"   // slab_caches, slab_mutex y get_slabinfo()
+
+#define SLAB_TOP_MAX 128
+
+/**
+ * Estructura que se copia al espacio de usuario, una por cache.
+ * Los valores son los mismos que muestra /proc/slabinfo.
+ */
+struct slab_cache_info {
+    char  name[32];
+    __u32 object_size;         // Tamaño del objeto pedido por el usuario del cache
+    __u32 slab_size;           // Tamaño por objeto incluyendo metadatos y alineación
+    __u64 active_objs;
+    __u64 total_objs;
+    __u64 total_bytes;         // Memoria de todos los slabs del cache
+    __u32 objs_per_slab;
+    __u32 reclaimable;         // 1 si el cache es SLAB_RECLAIM_ACCOUNT (dentries, inodes, ...)
+};
+
+/**
+ * Inserta info en top (ordenado de mayor a menor total_bytes, con *count
+ * elementos y capacidad max). Con max pequeño una inserción lineal es más
+ * barata que mantener un heap.
+ */
+static void slab_top_insert(struct slab_cache_info *top, unsigned int *count, unsigned int max,
+                            const struct slab_cache_info *info)
+{
+    unsigned int i = *count;
+
+    if (i == max) {
+        if (info->total_bytes <= top[max - 1].total_bytes)
+            return;
+        i = max - 1;
+    } else {
+        (*count)++;
+    }
+
+    while (i > 0 && top[i - 1].total_bytes < info->total_bytes) {
+        top[i] = top[i - 1];
+        i--;
+    }
+    top[i] = *info;
+}
+
+/**
+ * Syscall: _202000173_get_top_slab_caches
+ *
+ * Copia al buffer del usuario los n caches de slab que más memoria ocupan,
+ * de mayor a menor. Se recorre slab_caches una sola vez bajo slab_mutex y se
+ * copia todo con un solo copy_to_user al final.
+ *
+ * Requiere CAP_SYS_ADMIN: /proc/slabinfo solo es legible por root, y sin la
+ * verificación cualquier usuario podría tomar slab_mutex en un ciclo.
+ *
+ * Retorno: cantidad de caches copiados, -EPERM sin CAP_SYS_ADMIN, -EINVAL si
+ * n es 0 o mayor que SLAB_TOP_MAX, -EOPNOTSUPP si el kernel no tiene
+ * /proc/slabinfo.
+ */
+SYSCALL_DEFINE2(_202000173_get_top_slab_caches, struct slab_cache_info __user *, user_buf,
+                unsigned int, n)
+{
+#if defined(CONFIG_SLAB) || defined(CONFIG_SLUB_DEBUG)
+    struct slab_cache_info *top, info;
+    struct kmem_cache *s;
+    struct slabinfo sinfo;
+    unsigned int count = 0;
+    long ret;
+
+    if (!capable(CAP_SYS_ADMIN))
+        return -EPERM;
+    if (n == 0 || n > SLAB_TOP_MAX)
+        return -EINVAL;
+
+    top = kmalloc_array(n, sizeof(*top), GFP_KERNEL);
+    if (!top)
+        return -ENOMEM;
+
+    mutex_lock(&slab_mutex);
+    list_for_each_entry(s, &slab_caches, list) {
+        memset(&sinfo, 0, sizeof(sinfo));
+        get_slabinfo(s, &sinfo);
+
+        memset(&info, 0, sizeof(info));
+        strscpy(info.name, s->name, sizeof(info.name));
+        info.object_size   = s->object_size;
+        info.slab_size     = s->size;
+        info.active_objs   = sinfo.active_objs;
+        info.total_objs    = sinfo.num_objs;
+        info.total_bytes   = (u64)sinfo.num_slabs << (PAGE_SHIFT + sinfo.cache_order);
+        info.objs_per_slab = sinfo.objects_per_slab;
+        info.reclaimable   = !!(s->flags & SLAB_RECLAIM_ACCOUNT);
+
+        slab_top_insert(top, &count, n, &info);
+    }
+    mutex_unlock(&slab_mutex);
+
+    ret = count;
+    if (copy_to_user(user_buf, top, count * sizeof(*top)))
+        ret = -EFAULT;
+
+    kfree(top);
+    return ret;
+#else
+    return -EOPNOTSUPP;
+#endif
+}
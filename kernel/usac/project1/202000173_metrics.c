@@ -0,0 +1,111 @@
+#include <linux/kernel.h>
+#include <linux/mm.h>
+#include <linux/sched.h>
+#include <linux/sched/signal.h>
+#include <linux/kernel_stat.h>
+#include <linux/tick.h>
+#include <linux/cpumask.h>
+#include <linux/rcupdate.h>
+
+#include "202000173_metrics.h"
+
+/*
+ * Recolectores de métricas a nivel sistema. Cada uno hace una sola pasada
+ * sobre su fuente (contadores por CPU o lista de procesos) y deja el resultado
+ * en un registro de tamaño fijo.
+ */
+
+#define PAGES_TO_KB(pages) ((u64)(pages) << (PAGE_SHIFT - 10))
+
+void usac_metrics_collect_memory(struct usac_metrics_memory *mem)
+{
+    struct memory_snapshot snap;
+
+    usac_fill_memory_snapshot(&snap);
+    mem->total_kb      = PAGES_TO_KB(snap.total_ram);
+    mem->free_kb       = PAGES_TO_KB(snap.free_ram);
+    mem->swap_total_kb = PAGES_TO_KB(snap.swap_total);
+    mem->swap_free_kb  = PAGES_TO_KB(snap.swap_free);
+    mem->cache_kb      = PAGES_TO_KB(snap.cache_ram);
+    mem->buffer_kb     = PAGES_TO_KB(snap.buffer_ram);
+    mem->active_kb     = PAGES_TO_KB(snap.active_ram);
+    mem->inactive_kb   = PAGES_TO_KB(snap.inactive_ram);
+}
+
+// Tiempo de una CPU en ns; igual que /proc/stat, con NOHZ el tiempo idle lo lleva el tick
+void usac_metrics_read_cpu(int cpu, struct usac_metrics_cpu *cpu_stats)
+{
+    struct kernel_cpustat kcs;
+    u64 idle_us, iowait_us;
+
+    kcpustat_cpu_fetch(&kcs, cpu);
+    idle_us   = cpu_online(cpu) ? get_cpu_idle_time_us(cpu, NULL) : -1ULL;
+    iowait_us = cpu_online(cpu) ? get_cpu_iowait_time_us(cpu, NULL) : -1ULL;
+
+    cpu_stats->user    = kcs.cpustat[CPUTIME_USER];
+    cpu_stats->nice    = kcs.cpustat[CPUTIME_NICE];
+    cpu_stats->system  = kcs.cpustat[CPUTIME_SYSTEM];
+    cpu_stats->idle    = idle_us == -1ULL ? kcs.cpustat[CPUTIME_IDLE] : idle_us * NSEC_PER_USEC;
+    cpu_stats->iowait  = iowait_us == -1ULL ? kcs.cpustat[CPUTIME_IOWAIT] : iowait_us * NSEC_PER_USEC;
+    cpu_stats->irq     = kcs.cpustat[CPUTIME_IRQ];
+    cpu_stats->softirq = kcs.cpustat[CPUTIME_SOFTIRQ];
+    cpu_stats->steal   = kcs.cpustat[CPUTIME_STEAL];
+}
+
+void usac_metrics_collect_cpu(struct usac_metrics_cpu *cpu_stats)
+{
+    struct usac_metrics_cpu one;
+    u64 *total = (u64 *)cpu_stats, *part = (u64 *)&one;
+    size_t i;
+    int cpu;
+
+    memset(cpu_stats, 0, sizeof(*cpu_stats));
+    for_each_possible_cpu(cpu) {
+        usac_metrics_read_cpu(cpu, &one);
+        for (i = 0; i < sizeof(one) / sizeof(u64); i++)
+            total[i] += part[i];
+    }
+}
+
+static void add_io(struct usac_metrics_io *io, const struct task_io_accounting *ioac)
+{
+    io->rchar       += ioac->rchar;
+    io->wchar       += ioac->wchar;
+    io->syscr       += ioac->syscr;
+    io->syscw       += ioac->syscw;
+    io->read_bytes  += ioac->read_bytes;
+    io->write_bytes += ioac->write_bytes;
+}
+
+/*
+ * Una sola pasada por la lista de procesos para las estadísticas de I/O y
+ * el agregado de memoria de la syscall 551. signal->ioac guarda lo de los
+ * hilos que ya terminaron, así que el total no retrocede cuando uno sale.
+ */
+void usac_metrics_collect_tasks(struct usac_metrics_io *io, struct usac_metrics_tasks *tasks)
+{
+    struct task_struct *p, *t;
+
+    memset(io, 0, sizeof(*io));
+    memset(tasks, 0, sizeof(*tasks));
+
+    rcu_read_lock();
+    for_each_process(p) {
+        add_io(io, &p->signal->ioac);
+        for_each_thread(p, t)
+            add_io(io, &t->ioac);
+
+        if (p->flags & PF_KTHREAD)
+            continue;
+
+        // task_lock evita que mm se libere mientras se lee
+        task_lock(p);
+        if (p->mm) {
+            tasks->nr_processes++;
+            tasks->vm_kb  += PAGES_TO_KB(p->mm->total_vm);
+            tasks->rss_kb += PAGES_TO_KB(get_mm_rss(p->mm));
+        }
+        task_unlock(p);
+    }
+    rcu_read_unlock();
+}
@@ -0,0 +1,184 @@
+#ifndef _USAC_202000173_METRICS_H
+#define _USAC_202000173_METRICS_H
+
+#include <linux/types.h>
+
+/*
+ * Recolectores compartidos de las métricas del proyecto 1 y 2.
+ *
+ * Los usan la syscall 548, el canal genetlink "usac_metrics" y el archivo
+ * /proc/202000173_metrics en formato Prometheus, de modo que todos los
+ * consumidores comparten el mismo cálculo.
+ */
+
+/* Estructura que se copia al espacio de usuario (syscall 548), en páginas */
+struct memory_snapshot {
+    unsigned long total_ram;
+    unsigned long free_ram;
+    unsigned long swap_total;
+    unsigned long swap_free;
+    unsigned long cache_ram;
+    unsigned long buffer_ram;
+    unsigned long active_ram;
+    unsigned long inactive_ram;
+};
+
+/*
+ * Snapshot v2 (syscall 567): agrega al v1 la presión de memoria. Todo se
+ * llena en la misma llamada y se copia una sola vez. size permite que el
+ * espacio de usuario pase una versión más corta o más larga de la estructura.
+ */
+#define MEMORY_SNAPSHOT_V2_VERSION 2
+
+struct memory_snapshot_v2 {
+    __u32 version;
+    __u32 size;                  /* sizeof del kernel que llenó la estructura */
+    __u64 timestamp_ns;
+
+    /* Mismos valores que el v1, en páginas */
+    __u64 total_ram;
+    __u64 free_ram;
+    __u64 swap_total;
+    __u64 swap_free;
+    __u64 cache_ram;
+    __u64 buffer_ram;
+    __u64 active_ram;
+    __u64 inactive_ram;
+
+    /* PSI de memoria (/proc/pressure/memory) en centésimas de porcentaje */
+    __u32 psi_some_avg10;
+    __u32 psi_some_avg60;
+    __u32 psi_some_avg300;
+    __u32 psi_full_avg10;
+    __u32 psi_full_avg60;
+    __u32 psi_full_avg300;
+    __u64 psi_some_total_us;
+    __u64 psi_full_total_us;
+
+    /* Contadores acumulados de /proc/vmstat */
+    __u64 pgscan;                /* kswapd + directo + khugepaged */
+    __u64 pgsteal;
+    __u64 pgfault;
+    __u64 pgmajfault;
+    __u64 pswpin;
+    __u64 pswpout;
+    __u64 compact_stall;
+    __u64 compact_fail;
+    __u64 compact_success;
+
+    /* Páginas por segundo en la última ventana de al menos un segundo */
+    __u64 pswpin_rate;
+    __u64 pswpout_rate;
+};
+
+/*
+ * Sección opcional de la syscall 567: bloques libres del buddy allocator por
+ * orden, para cada zona poblada de cada nodo NUMA (lo mismo que
+ * /proc/buddyinfo) y el índice de fragmentación de cada orden
+ * (/sys/kernel/debug/extfrag/extfrag_index).
+ */
+#define MEMORY_FRAG_MAX_ORDERS 16
+
+struct memory_zone_frag {
+    __s32 node;
+    __u32 zone_idx;
+    char  zone_name[16];
+    __u32 nr_orders;             /* Órdenes válidos en los arreglos (MAX_ORDER + 1) */
+    __u32 reserved;
+    __u64 managed_pages;
+    __u64 free_pages;
+    __u64 nr_free[MEMORY_FRAG_MAX_ORDERS];
+    /*
+     * Milésimas: cerca de 0 la falla de una reserva de ese orden se debe a
+     * falta de memoria, cerca de 1000 a fragmentación. -1000 significa que hay
+     * bloques libres suficientes de ese orden o mayores.
+     */
+    __s32 frag_index[MEMORY_FRAG_MAX_ORDERS];
+};
+
+/* Registros binarios compactos del canal genetlink (un atributo NLA_BINARY cada uno) */
+struct usac_metrics_memory {
+    __u64 total_kb;
+    __u64 free_kb;
+    __u64 swap_total_kb;
+    __u64 swap_free_kb;
+    __u64 cache_kb;
+    __u64 buffer_kb;
+    __u64 active_kb;
+    __u64 inactive_kb;
+};
+
+/* Tiempo acumulado de todas las CPUs en nanosegundos (mismo orden que /proc/stat) */
+struct usac_metrics_cpu {
+    __u64 user;
+    __u64 nice;
+    __u64 system;
+    __u64 idle;
+    __u64 iowait;
+    __u64 irq;
+    __u64 softirq;
+    __u64 steal;
+};
+
+/* Suma de task->ioac de todos los hilos vivos y terminados (syscall 549 a nivel sistema) */
+struct usac_metrics_io {
+    __u64 rchar;
+    __u64 wchar;
+    __u64 syscr;
+    __u64 syscw;
+    __u64 read_bytes;
+    __u64 write_bytes;
+};
+
+/* Agregado de la syscall 551 sobre todos los procesos con memoria de usuario */
+struct usac_metrics_tasks {
+    __u64 nr_processes;
+    __u64 vm_kb;
+    __u64 rss_kb;
+};
+
+void usac_fill_memory_snapshot(struct memory_snapshot *snap);
+void usac_fill_memory_snapshot_v2(struct memory_snapshot_v2 *snap);
+void usac_metrics_collect_memory(struct usac_metrics_memory *mem);
+void usac_metrics_read_cpu(int cpu, struct usac_metrics_cpu *cpu_stats);
+void usac_metrics_collect_cpu(struct usac_metrics_cpu *cpu_stats);
+void usac_metrics_collect_tasks(struct usac_metrics_io *io, struct usac_metrics_tasks *tasks);
+
+/* Protocolo de la familia genetlink "usac_metrics" */
+#define USAC_METRICS_GENL_NAME     "usac_metrics"
+#define USAC_METRICS_GENL_VERSION  1
+#define USAC_METRICS_MCGRP_NAME    "metrics"
+
+enum {
+    USAC_METRICS_CMD_UNSPEC,
+    USAC_METRICS_CMD_SUBSCRIBE,    /* Registra el socket con intervalo, umbral y máscara */
+    USAC_METRICS_CMD_UNSUBSCRIBE,
+    USAC_METRICS_CMD_GET,          /* Respuesta inmediata con la última muestra */
+    USAC_METRICS_CMD_REPORT,       /* Notificación enviada por el kernel */
+    __USAC_METRICS_CMD_MAX,
+};
+#define USAC_METRICS_CMD_MAX (__USAC_METRICS_CMD_MAX - 1)
+
+enum {
+    USAC_METRICS_A_UNSPEC,
+    USAC_METRICS_A_INTERVAL_MS,    /* u32: periodo de envío */
+    USAC_METRICS_A_THRESHOLD,      /* u32: cambio relativo en % que fuerza un envío (0 = nunca) */
+    USAC_METRICS_A_MASK,           /* u32: registros deseados (USAC_METRICS_F_*) */
+    USAC_METRICS_A_SEQ,            /* u64: número de muestra */
+    USAC_METRICS_A_TIMESTAMP,      /* u64: CLOCK_REALTIME en ns */
+    USAC_METRICS_A_MEMORY,         /* struct usac_metrics_memory */
+    USAC_METRICS_A_CPU,            /* struct usac_metrics_cpu */
+    USAC_METRICS_A_IO,             /* struct usac_metrics_io */
+    USAC_METRICS_A_TASKS,          /* struct usac_metrics_tasks */
+    USAC_METRICS_A_PAD,
+    __USAC_METRICS_A_MAX,
+};
+#define USAC_METRICS_A_MAX (__USAC_METRICS_A_MAX - 1)
+
+#define USAC_METRICS_F_MEMORY  0x1
+#define USAC_METRICS_F_CPU     0x2
+#define USAC_METRICS_F_IO      0x4
+#define USAC_METRICS_F_TASKS   0x8
+#define USAC_METRICS_F_ALL     0xf
+
+#endif /* _USAC_202000173_METRICS_H */
@@ -0,0 +1,451 @@
+#include <linux/kernel.h>
+#include <linux/init.h>
+#include <linux/slab.h>
+#include <linux/list.h>
+#include <linux/mutex.h>
+#include <linux/atomic.h>
+#include <linux/jiffies.h>
+#include <linux/ktime.h>
+#include <linux/workqueue.h>
+#include <linux/notifier.h>
+#include <linux/netlink.h>
+#include <net/genetlink.h>
+#include <net/net_namespace.h>
+
+#include "202000173_metrics.h"
+
+/*
+ * Canal genetlink "usac_metrics".
+ *
+ * En lugar de que cada agente llame periódicamente a las syscalls, los
+ * consumidores se suscriben con USAC_METRICS_CMD_SUBSCRIBE indicando su
+ * intervalo, un umbral de cambio opcional y los registros que quieren. Un
+ * único trabajo periódico calcula la muestra una vez por tick, arma un mensaje
+ * por cada máscara distinta y envía una copia (skb_clone) a cada suscriptor
+ * que le toca. Los sockets que solo se unen al grupo multicast "metrics"
+ * reciben todos los registros cada USAC_METRICS_DEFAULT_INTERVAL_MS.
+ *
+ * Cada suscripción (una por socket) mantiene vivo un trabajo periódico, así
+ * que SUBSCRIBE requiere CAP_NET_ADMIN; el grupo multicast no tiene costo por
+ * oyente y queda abierto a cualquier usuario.
+ *
+ * Si no hay suscriptores ni oyentes del grupo el trabajo no se reprograma,
+ * así que el canal no tiene costo mientras nadie lo usa.
+ */
+#define USAC_METRICS_MIN_INTERVAL_MS      100
+#define USAC_METRICS_MAX_INTERVAL_MS      3600000
+#define USAC_METRICS_DEFAULT_INTERVAL_MS  1000
+#define USAC_METRICS_THRESHOLD_TICK_MS    250   /* Frecuencia de revisión del umbral */
+#define USAC_METRICS_MAX_THRESHOLD        1000  /* En porcentaje */
+#define USAC_METRICS_MAX_SUBSCRIBERS      64
+
+struct usac_metrics_sample {
+    u64 seq;
+    u64 timestamp_ns;
+    struct usac_metrics_memory memory;
+    struct usac_metrics_cpu cpu;
+    struct usac_metrics_io io;
+    struct usac_metrics_tasks tasks;
+};
+
+struct usac_metrics_subscriber {
+    u32 portid;
+    unsigned int interval_ms;
+    unsigned int threshold;
+    u32 mask;
+    unsigned long next_due;                 /* jiffies del próximo envío periódico */
+    struct usac_metrics_sample last_sent;   /* Base para comparar contra el umbral */
+    struct list_head list;
+};
+
+static LIST_HEAD(usac_metrics_subscribers);
+static unsigned int usac_metrics_nr_subscribers;
+static unsigned long usac_metrics_mcast_next_due;
+static unsigned long usac_metrics_bind_until;   /* jiffies; ver usac_metrics_mcast_bind */
+static struct usac_metrics_sample usac_metrics_last;
+static DEFINE_MUTEX(usac_metrics_lock);  /* Protege todo lo anterior */
+
+static void usac_metrics_work_fn(struct work_struct *work);
+static DECLARE_DELAYED_WORK(usac_metrics_work, usac_metrics_work_fn);
+
+static struct genl_family usac_metrics_family;
+
+// Calcula solo los registros pedidos en mask; los demás conservan su valor anterior.
+static void usac_metrics_sample(struct usac_metrics_sample *s, u32 mask)
+{
+    static atomic64_t seq;
+
+    s->seq = atomic64_inc_return(&seq);
+    s->timestamp_ns = ktime_get_real_ns();
+    if (mask & USAC_METRICS_F_MEMORY)
+        usac_metrics_collect_memory(&s->memory);
+    if (mask & USAC_METRICS_F_CPU)
+        usac_metrics_collect_cpu(&s->cpu);
+    if (mask & (USAC_METRICS_F_IO | USAC_METRICS_F_TASKS))
+        usac_metrics_collect_tasks(&s->io, &s->tasks);
+}
+
+static size_t usac_metrics_msg_size(u32 mask)
+{
+    size_t size = 2 * nla_total_size_64bit(sizeof(u64));
+
+    if (mask & USAC_METRICS_F_MEMORY)
+        size += nla_total_size(sizeof(struct usac_metrics_memory));
+    if (mask & USAC_METRICS_F_CPU)
+        size += nla_total_size(sizeof(struct usac_metrics_cpu));
+    if (mask & USAC_METRICS_F_IO)
+        size += nla_total_size(sizeof(struct usac_metrics_io));
+    if (mask & USAC_METRICS_F_TASKS)
+        size += nla_total_size(sizeof(struct usac_metrics_tasks));
+    return size;
+}
+
+static struct sk_buff *usac_metrics_build(const struct usac_metrics_sample *s, u32 mask,
+                                          u32 portid, u32 seq)
+{
+    struct sk_buff *skb;
+    void *hdr;
+
+    skb = genlmsg_new(usac_metrics_msg_size(mask), GFP_KERNEL);
+    if (!skb)
+        return NULL;
+
+    hdr = genlmsg_put(skb, portid, seq, &usac_metrics_family, 0, USAC_METRICS_CMD_REPORT);
+    if (!hdr)
+        goto err;
+
+    if (nla_put_u64_64bit(skb, USAC_METRICS_A_SEQ, s->seq, USAC_METRICS_A_PAD) ||
+        nla_put_u64_64bit(skb, USAC_METRICS_A_TIMESTAMP, s->timestamp_ns, USAC_METRICS_A_PAD))
+        goto err;
+    if ((mask & USAC_METRICS_F_MEMORY) &&
+        nla_put(skb, USAC_METRICS_A_MEMORY, sizeof(s->memory), &s->memory))
+        goto err;
+    if ((mask & USAC_METRICS_F_CPU) &&
+        nla_put(skb, USAC_METRICS_A_CPU, sizeof(s->cpu), &s->cpu))
+        goto err;
+    if ((mask & USAC_METRICS_F_IO) &&
+        nla_put(skb, USAC_METRICS_A_IO, sizeof(s->io), &s->io))
+        goto err;
+    if ((mask & USAC_METRICS_F_TASKS) &&
+        nla_put(skb, USAC_METRICS_A_TASKS, sizeof(s->tasks), &s->tasks))
+        goto err;
+
+    genlmsg_end(skb, hdr);
+    return skb;
+
+err:
+    nlmsg_free(skb);
+    return NULL;
+}
+
+// Cambio relativo de un valor en porcentaje, comparado contra el umbral.
+static bool usac_metrics_exceeds(u64 old, u64 new, unsigned int threshold)
+{
+    u64 diff = old > new ? old - new : new - old;
+
+    return diff * 100 >= (u64)threshold * max_t(u64, old, 1);
+}
+
+/*
+ * El umbral se aplica a los registros que son niveles (memoria y procesos).
+ * CPU e I/O son contadores acumulados que siempre crecen; esos se envían
+ * con el intervalo, junto con cualquier envío adelantado por el umbral.
+ */
+static bool usac_metrics_changed(const struct usac_metrics_subscriber *sub,
+                                 const struct usac_metrics_sample *s)
+{
+    const u64 *old, *new;
+    size_t i;
+
+    if (sub->mask & USAC_METRICS_F_MEMORY) {
+        old = (const u64 *)&sub->last_sent.memory;
+        new = (const u64 *)&s->memory;
+        for (i = 0; i < sizeof(s->memory) / sizeof(u64); i++) {
+            if (usac_metrics_exceeds(old[i], new[i], sub->threshold))
+                return true;
+        }
+    }
+    if (sub->mask & USAC_METRICS_F_TASKS) {
+        old = (const u64 *)&sub->last_sent.tasks;
+        new = (const u64 *)&s->tasks;
+        for (i = 0; i < sizeof(s->tasks) / sizeof(u64); i++) {
+            if (usac_metrics_exceeds(old[i], new[i], sub->threshold))
+                return true;
+        }
+    }
+    return false;
+}
+
+static struct usac_metrics_subscriber *usac_metrics_find(u32 portid)
+{
+    struct usac_metrics_subscriber *sub;
+
+    list_for_each_entry(sub, &usac_metrics_subscribers, list) {
+        if (sub->portid == portid)
+            return sub;
+    }
+    return NULL;
+}
+
+static void usac_metrics_remove(struct usac_metrics_subscriber *sub)
+{
+    list_del(&sub->list);
+    usac_metrics_nr_subscribers--;
+    kfree(sub);
+}
+
+// Periodo del próximo tick en ms, o 0 si nadie está escuchando. Requiere usac_metrics_lock.
+static unsigned int usac_metrics_next_tick(void)
+{
+    struct usac_metrics_subscriber *sub;
+    unsigned int tick = 0, t;
+
+    list_for_each_entry(sub, &usac_metrics_subscribers, list) {
+        t = sub->threshold ? min_t(unsigned int, sub->interval_ms, USAC_METRICS_THRESHOLD_TICK_MS)
+                           : sub->interval_ms;
+        tick = tick ? min(tick, t) : t;
+    }
+    if (genl_has_listeners(&usac_metrics_family, &init_net, 0) ||
+        time_before(jiffies, READ_ONCE(usac_metrics_bind_until)))
+        tick = tick ? min_t(unsigned int, tick, USAC_METRICS_DEFAULT_INTERVAL_MS)
+                    : USAC_METRICS_DEFAULT_INTERVAL_MS;
+    return tick;
+}
+
+static void usac_metrics_work_fn(struct work_struct *work)
+{
+    struct sk_buff *built[USAC_METRICS_F_ALL + 1] = {};
+    struct usac_metrics_subscriber *sub, *tmp;
+    struct sk_buff *skb;
+    unsigned long now = jiffies;
+    unsigned int tick;
+    bool mcast;
+    u32 need;
+    int err, i;
+
+    mutex_lock(&usac_metrics_lock);
+
+    mcast = genl_has_listeners(&usac_metrics_family, &init_net, 0) &&
+            time_after_eq(now, usac_metrics_mcast_next_due);
+    need = mcast ? USAC_METRICS_F_ALL : 0;
+    list_for_each_entry(sub, &usac_metrics_subscribers, list) {
+        if (sub->threshold || time_after_eq(now, sub->next_due))
+            need |= sub->mask;
+    }
+
+    // Un solo cálculo por tick, compartido por todos los consumidores
+    if (need)
+        usac_metrics_sample(&usac_metrics_last, need);
+
+    list_for_each_entry_safe(sub, tmp, &usac_metrics_subscribers, list) {
+        if (!time_after_eq(now, sub->next_due) &&
+            !(sub->threshold && usac_metrics_changed(sub, &usac_metrics_last)))
+            continue;
+
+        if (!built[sub->mask])
+            built[sub->mask] = usac_metrics_build(&usac_metrics_last, sub->mask, 0, 0);
+        if (!built[sub->mask])
+            break;
+        skb = skb_clone(built[sub->mask], GFP_KERNEL);
+        if (!skb)
+            break;
+
+        err = genlmsg_unicast(&init_net, skb, sub->portid);
+        if (err == -ECONNREFUSED) {
+            // El socket ya no existe
+            usac_metrics_remove(sub);
+            continue;
+        }
+
+        // Con el buffer del socket lleno (-EAGAIN) se pierde esta muestra, no la suscripción
+        sub->last_sent = usac_metrics_last;
+        sub->next_due = now + msecs_to_jiffies(sub->interval_ms);
+    }
+
+    if (mcast) {
+        if (!built[USAC_METRICS_F_ALL])
+            built[USAC_METRICS_F_ALL] = usac_metrics_build(&usac_metrics_last, USAC_METRICS_F_ALL, 0, 0);
+        if (built[USAC_METRICS_F_ALL]) {
+            skb = skb_clone(built[USAC_METRICS_F_ALL], GFP_KERNEL);
+            if (skb)
+                genlmsg_multicast(&usac_metrics_family, skb, 0, 0, GFP_KERNEL);
+        }
+        usac_metrics_mcast_next_due = now + msecs_to_jiffies(USAC_METRICS_DEFAULT_INTERVAL_MS);
+    }
+
+    tick = usac_metrics_next_tick();
+    mutex_unlock(&usac_metrics_lock);
+
+    for (i = 0; i <= USAC_METRICS_F_ALL; i++)
+        nlmsg_free(built[i]);
+
+    if (tick)
+        schedule_delayed_work(&usac_metrics_work, msecs_to_jiffies(tick));
+}
+
+static int usac_metrics_subscribe(struct sk_buff *skb, struct genl_info *info)
+{
+    struct usac_metrics_subscriber *sub;
+    u32 mask = USAC_METRICS_F_ALL;
+
+    if (info->attrs[USAC_METRICS_A_MASK])
+        mask = nla_get_u32(info->attrs[USAC_METRICS_A_MASK]);
+    if (!mask)
+        return -EINVAL;
+
+    mutex_lock(&usac_metrics_lock);
+    sub = usac_metrics_find(info->snd_portid);
+    if (!sub) {
+        if (usac_metrics_nr_subscribers >= USAC_METRICS_MAX_SUBSCRIBERS) {
+            mutex_unlock(&usac_metrics_lock);
+            return -ENOSPC;
+        }
+        sub = kzalloc(sizeof(*sub), GFP_KERNEL);
+        if (!sub) {
+            mutex_unlock(&usac_metrics_lock);
+            return -ENOMEM;
+        }
+        sub->portid = info->snd_portid;
+        list_add_tail(&sub->list, &usac_metrics_subscribers);
+        usac_metrics_nr_subscribers++;
+    }
+
+    // Volver a suscribirse reemplaza la configuración anterior
+    sub->interval_ms = USAC_METRICS_DEFAULT_INTERVAL_MS;
+    if (info->attrs[USAC_METRICS_A_INTERVAL_MS])
+        sub->interval_ms = nla_get_u32(info->attrs[USAC_METRICS_A_INTERVAL_MS]);
+    sub->threshold = 0;
+    if (info->attrs[USAC_METRICS_A_THRESHOLD])
+        sub->threshold = nla_get_u32(info->attrs[USAC_METRICS_A_THRESHOLD]);
+    sub->mask = mask;
+    sub->next_due = jiffies;  // La primera muestra sale de inmediato
+    mutex_unlock(&usac_metrics_lock);
+
+    mod_delayed_work(system_wq, &usac_metrics_work, 0);
+    return 0;
+}
+
+static int usac_metrics_unsubscribe(struct sk_buff *skb, struct genl_info *info)
+{
+    struct usac_metrics_subscriber *sub;
+
+    mutex_lock(&usac_metrics_lock);
+    sub = usac_metrics_find(info->snd_portid);
+    if (sub)
+        usac_metrics_remove(sub);
+    mutex_unlock(&usac_metrics_lock);
+
+    return sub ? 0 : -ENOENT;
+}
+
+// Consulta puntual: calcula y responde solo a quien pregunta.
+static int usac_metrics_get(struct sk_buff *skb, struct genl_info *info)
+{
+    struct usac_metrics_sample sample = {};
+    struct sk_buff *reply;
+    u32 mask = USAC_METRICS_F_ALL;
+
+    if (info->attrs[USAC_METRICS_A_MASK])
+        mask = nla_get_u32(info->attrs[USAC_METRICS_A_MASK]);
+    if (!mask)
+        return -EINVAL;
+
+    usac_metrics_sample(&sample, mask);
+    reply = usac_metrics_build(&sample, mask, info->snd_portid, info->snd_seq);
+    if (!reply)
+        return -ENOMEM;
+
+    return genlmsg_reply(reply, info);
+}
+
+/*
+ * Un socket se une al grupo multicast: arrancar el trabajo si estaba detenido.
+ * netlink llama a mcast_bind antes de agregar el socket al grupo, así que
+ * genl_has_listeners() todavía puede ser falso cuando corre el trabajo; este
+ * sigue activo al menos dos intervalos por defecto aunque no vea oyentes.
+ */
+static int usac_metrics_mcast_bind(struct net *net, int group)
+{
+    WRITE_ONCE(usac_metrics_bind_until,
+               jiffies + 2 * msecs_to_jiffies(USAC_METRICS_DEFAULT_INTERVAL_MS));
+    mod_delayed_work(system_wq, &usac_metrics_work,
+                     msecs_to_jiffies(USAC_METRICS_MIN_INTERVAL_MS));
+    return 0;
+}
+
+// Elimina la suscripción cuando el socket se cierra sin UNSUBSCRIBE.
+static int usac_metrics_netlink_event(struct notifier_block *nb, unsigned long event, void *ptr)
+{
+    struct netlink_notify *n = ptr;
+    struct usac_metrics_subscriber *sub;
+
+    if (event != NETLINK_URELEASE || n->protocol != NETLINK_GENERIC)
+        return NOTIFY_DONE;
+
+    mutex_lock(&usac_metrics_lock);
+    sub = usac_metrics_find(n->portid);
+    if (sub)
+        usac_metrics_remove(sub);
+    mutex_unlock(&usac_metrics_lock);
+    return NOTIFY_DONE;
+}
+
+static struct notifier_block usac_metrics_netlink_notifier = {
+    .notifier_call = usac_metrics_netlink_event,
+};
+
+static const struct nla_policy usac_metrics_policy[USAC_METRICS_A_MAX + 1] = {
+    [USAC_METRICS_A_INTERVAL_MS] = NLA_POLICY_RANGE(NLA_U32, USAC_METRICS_MIN_INTERVAL_MS,
+                                                    USAC_METRICS_MAX_INTERVAL_MS),
+    [USAC_METRICS_A_THRESHOLD]   = NLA_POLICY_MAX(NLA_U32, USAC_METRICS_MAX_THRESHOLD),
+    [USAC_METRICS_A_MASK]        = NLA_POLICY_MASK(NLA_U32, USAC_METRICS_F_ALL),
+};
+
+static const struct genl_small_ops usac_metrics_ops[] = {
+    {
+        .cmd   = USAC_METRICS_CMD_SUBSCRIBE,
+        .doit  = usac_metrics_subscribe,
+        .flags = GENL_ADMIN_PERM,
+    },
+    {
+        .cmd  = USAC_METRICS_CMD_UNSUBSCRIBE,
+        .doit = usac_metrics_unsubscribe,
+    },
+    {
+        .cmd  = USAC_METRICS_CMD_GET,
+        .doit = usac_metrics_get,
+    },
+};
+
+static const struct genl_multicast_group usac_metrics_mcgrps[] = {
+    { .name = USAC_METRICS_MCGRP_NAME },
+};
+
+static struct genl_family usac_metrics_family __ro_after_init = {
+    .name          = USAC_METRICS_GENL_NAME,
+    .version       = USAC_METRICS_GENL_VERSION,
+    .maxattr       = USAC_METRICS_A_MAX,
+    .policy        = usac_metrics_policy,
+    .module        = THIS_MODULE,
+    .small_ops     = usac_metrics_ops,
+    .n_small_ops   = ARRAY_SIZE(usac_metrics_ops),
+    .resv_start_op = __USAC_METRICS_CMD_MAX,
+    .mcgrps        = usac_metrics_mcgrps,
+    .n_mcgrps      = ARRAY_SIZE(usac_metrics_mcgrps),
+    .mcast_bind    = usac_metrics_mcast_bind,
+};
+
+static int __init usac_metrics_netlink_init(void)
+{
+    int ret;
+
+    ret = genl_register_family(&usac_metrics_family);
+    if (ret)
+        return ret;
+
+    ret = netlink_register_notifier(&usac_metrics_netlink_notifier);
+    if (ret)
+        genl_unregister_family(&usac_metrics_family);
+    return ret;
+}
+late_initcall(usac_metrics_netlink_init);
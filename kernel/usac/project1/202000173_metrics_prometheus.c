@@ -0,0 +1,269 @@
+#include <linux/kernel.h>
+#include <linux/init.h>
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
+#include <linux/slab.h>
+#include <linux/cpumask.h>
+#include <linux/fs.h>
+#include <linux/fs_struct.h>
+#include <linux/path.h>
+#include <linux/statfs.h>
+#include <linux/sched.h>
+
+#include "202000173_metrics.h"
+#include "../project3/202000173_memory_limit.h"
+
+/*
+ * /proc/202000173_metrics: todas las métricas del proyecto 1 y 2 en formato
+ * de exposición de Prometheus, para que el scraper lo lea directamente.
+ *
+ * El archivo se recorre con seq_operations, una sección por posición, y las
+ * CPUs van al final, una por posición. Así cada show() escribe solo unas
+ * pocas líneas y el buffer que se reserva al abrir nunca tiene que crecer,
+ * sin importar cuántas CPUs tenga el sistema.
+ */
+#define METRICS_PROM_BUF_SIZE (2 * PAGE_SIZE)
+
+enum {
+    METRICS_PROM_MEMORY,
+    METRICS_PROM_TASKS,
+    METRICS_PROM_IO,
+    METRICS_PROM_DISK,
+    METRICS_PROM_LIMITS,
+    METRICS_PROM_CPU_HEADER,
+    METRICS_PROM_CPU_FIRST,   /* Posición de la CPU 0; las demás le siguen */
+};
+
+static const char * const metrics_prom_cpu_modes[] = {
+    "user", "nice", "system", "idle", "iowait", "irq", "softirq", "steal",
+};
+
+static void metrics_prom_header(struct seq_file *m, const char *name, const char *type,
+                                const char *help)
+{
+    seq_printf(m, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+static void metrics_prom_show_memory(struct seq_file *m)
+{
+    static const char * const types[] = {
+        "total", "free", "swap_total", "swap_free", "cache", "buffer", "active", "inactive",
+    };
+    struct usac_metrics_memory mem;
+    const u64 *value = (const u64 *)&mem;
+    int i;
+
+    usac_metrics_collect_memory(&mem);
+    metrics_prom_header(m, "usac_memory_bytes", "gauge", "System memory by type (syscall 548).");
+    for (i = 0; i < ARRAY_SIZE(types); i++)
+        seq_printf(m, "usac_memory_bytes{type=\"%s\"} %llu\n", types[i], value[i] * 1024);
+}
+
+/*
+ * Los agregados de procesos y de I/O salen de la misma pasada por la lista de
+ * procesos; se calcula en la sección de procesos y se guarda en m->private
+ * para la sección siguiente.
+ */
+struct metrics_prom_state {
+    struct usac_metrics_io io;
+    struct usac_metrics_tasks tasks;
+    bool collected;
+};
+
+static void metrics_prom_show_tasks(struct seq_file *m, struct metrics_prom_state *st)
+{
+    usac_metrics_collect_tasks(&st->io, &st->tasks);
+    st->collected = true;
+
+    metrics_prom_header(m, "usac_processes", "gauge", "Processes with a user address space.");
+    seq_printf(m, "usac_processes %llu\n", st->tasks.nr_processes);
+    metrics_prom_header(m, "usac_processes_virtual_bytes", "gauge",
+                        "Sum of total_vm over all processes (syscall 551).");
+    seq_printf(m, "usac_processes_virtual_bytes %llu\n", st->tasks.vm_kb * 1024);
+    metrics_prom_header(m, "usac_processes_resident_bytes", "gauge",
+                        "Sum of RSS over all processes (syscall 551).");
+    seq_printf(m, "usac_processes_resident_bytes %llu\n", st->tasks.rss_kb * 1024);
+}
+
+static void metrics_prom_show_io(struct seq_file *m, struct metrics_prom_state *st)
+{
+    // Si la lectura empezó después de la sección de procesos hay que recolectar aquí
+    if (!st->collected)
+        usac_metrics_collect_tasks(&st->io, &st->tasks);
+    st->collected = false;
+
+    metrics_prom_header(m, "usac_io_read_chars_total", "counter",
+                        "Bytes passed to read syscalls by all threads (syscall 549).");
+    seq_printf(m, "usac_io_read_chars_total %llu\n", st->io.rchar);
+    metrics_prom_header(m, "usac_io_write_chars_total", "counter",
+                        "Bytes passed to write syscalls by all threads (syscall 549).");
+    seq_printf(m, "usac_io_write_chars_total %llu\n", st->io.wchar);
+    metrics_prom_header(m, "usac_io_read_syscalls_total", "counter", "Read syscalls by all threads.");
+    seq_printf(m, "usac_io_read_syscalls_total %llu\n", st->io.syscr);
+    metrics_prom_header(m, "usac_io_write_syscalls_total", "counter", "Write syscalls by all threads.");
+    seq_printf(m, "usac_io_write_syscalls_total %llu\n", st->io.syscw);
+    metrics_prom_header(m, "usac_io_read_bytes_total", "counter", "Bytes read from storage.");
+    seq_printf(m, "usac_io_read_bytes_total %llu\n", st->io.read_bytes);
+    metrics_prom_header(m, "usac_io_write_bytes_total", "counter", "Bytes written to storage.");
+    seq_printf(m, "usac_io_write_bytes_total %llu\n", st->io.write_bytes);
+}
+
+// Sistema de archivos raíz de quien lee el archivo (dentro de un contenedor, el suyo).
+static void metrics_prom_show_disk(struct seq_file *m)
+{
+    struct kstatfs st;
+    struct path root;
+    int err;
+
+    get_fs_root(current->fs, &root);
+    err = vfs_statfs(&root, &st);
+    path_put(&root);
+
+    metrics_prom_header(m, "usac_filesystem_error", "gauge", "1 if statfs on the root failed.");
+    seq_printf(m, "usac_filesystem_error{mountpoint=\"/\"} %d\n", err ? 1 : 0);
+    if (err)
+        return;
+
+    metrics_prom_header(m, "usac_filesystem_size_bytes", "gauge", "Root filesystem size.");
+    seq_printf(m, "usac_filesystem_size_bytes{mountpoint=\"/\"} %llu\n", st.f_blocks * st.f_bsize);
+    metrics_prom_header(m, "usac_filesystem_free_bytes", "gauge", "Root filesystem free space.");
+    seq_printf(m, "usac_filesystem_free_bytes{mountpoint=\"/\"} %llu\n", st.f_bfree * st.f_bsize);
+    metrics_prom_header(m, "usac_filesystem_avail_bytes", "gauge",
+                        "Root filesystem space available to unprivileged users.");
+    seq_printf(m, "usac_filesystem_avail_bytes{mountpoint=\"/\"} %llu\n", st.f_bavail * st.f_bsize);
+}
+
+static void metrics_prom_show_limits(struct seq_file *m)
+{
+    metrics_prom_header(m, "usac_memory_limit_groups", "gauge",
+                        "Processes registered with a memory limit (syscall 557).");
+    seq_printf(m, "usac_memory_limit_groups %u\n", READ_ONCE(memory_limit_nr_owners));
+    metrics_prom_header(m, "usac_memory_limit_processes", "gauge",
+                        "Processes covered by a memory limit, including inherited ones.");
+    seq_printf(m, "usac_memory_limit_processes %u\n", READ_ONCE(memory_limit_nr_entries));
+    metrics_prom_header(m, "usac_memory_limit_users", "gauge",
+                        "Users with a memory limit (syscall 562).");
+    seq_printf(m, "usac_memory_limit_users %u\n", READ_ONCE(memory_limit_nr_users));
+}
+
+static void metrics_prom_show_cpu(struct seq_file *m, int cpu)
+{
+    struct usac_metrics_cpu stats;
+    const u64 *value = (const u64 *)&stats;
+    int i;
+
+    usac_metrics_read_cpu(cpu, &stats);
+    for (i = 0; i < ARRAY_SIZE(metrics_prom_cpu_modes); i++)
+        seq_printf(m, "usac_cpu_seconds_total{cpu=\"%d\",mode=\"%s\"} %llu.%09llu\n",
+                   cpu, metrics_prom_cpu_modes[i],
+                   value[i] / NSEC_PER_SEC, value[i] % NSEC_PER_SEC);
+}
+
+/*
+ * El iterador devuelve la posición + 1 como cursor (nunca NULL). Para las
+ * posiciones de CPU se saltan los ids que no son posibles.
+ */
+static void *metrics_prom_cursor(loff_t *pos)
+{
+    unsigned int cpu;
+
+    if (*pos < METRICS_PROM_CPU_FIRST)
+        return (void *)(uintptr_t)(*pos + 1);
+
+    cpu = cpumask_next((int)(*pos - METRICS_PROM_CPU_FIRST) - 1, cpu_possible_mask);
+    if (cpu >= nr_cpu_ids)
+        return NULL;
+    *pos = METRICS_PROM_CPU_FIRST + cpu;
+    return (void *)(uintptr_t)(*pos + 1);
+}
+
+static void *metrics_prom_start(struct seq_file *m, loff_t *pos)
+{
+    return metrics_prom_cursor(pos);
+}
+
+static void *metrics_prom_next(struct seq_file *m, void *v, loff_t *pos)
+{
+    (*pos)++;
+    return metrics_prom_cursor(pos);
+}
+
+static void metrics_prom_stop(struct seq_file *m, void *v)
+{
+}
+
+static int metrics_prom_show(struct seq_file *m, void *v)
+{
+    loff_t pos = (uintptr_t)v - 1;
+
+    switch (pos) {
+    case METRICS_PROM_MEMORY:
+        metrics_prom_show_memory(m);
+        break;
+    case METRICS_PROM_TASKS:
+        metrics_prom_show_tasks(m, m->private);
+        break;
+    case METRICS_PROM_IO:
+        metrics_prom_show_io(m, m->private);
+        break;
+    case METRICS_PROM_DISK:
+        metrics_prom_show_disk(m);
+        break;
+    case METRICS_PROM_LIMITS:
+        metrics_prom_show_limits(m);
+        break;
+    case METRICS_PROM_CPU_HEADER:
+        metrics_prom_header(m, "usac_cpu_seconds_total", "counter",
+                            "Seconds each CPU spent in each mode.");
+        break;
+    default:
+        metrics_prom_show_cpu(m, pos - METRICS_PROM_CPU_FIRST);
+        break;
+    }
+    return 0;
+}
+
+static const struct seq_operations metrics_prom_seq_ops = {
+    .start = metrics_prom_start,
+    .next  = metrics_prom_next,
+    .stop  = metrics_prom_stop,
+    .show  = metrics_prom_show,
+};
+
+static int metrics_prom_open(struct inode *inode, struct file *file)
+{
+    struct seq_file *m;
+    char *buf;
+    int ret;
+
+    // Se reserva el buffer completo aquí para que seq_read no lo reasigne a mitad de lectura
+    buf = kvmalloc(METRICS_PROM_BUF_SIZE, GFP_KERNEL_ACCOUNT);
+    if (!buf)
+        return -ENOMEM;
+
+    ret = seq_open_private(file, &metrics_prom_seq_ops, sizeof(struct metrics_prom_state));
+    if (ret) {
+        kvfree(buf);
+        return ret;
+    }
+
+    m = file->private_data;
+    m->buf = buf;
+    m->size = METRICS_PROM_BUF_SIZE;
+    return 0;
+}
+
+static const struct proc_ops metrics_prom_ops = {
+    .proc_open    = metrics_prom_open,
+    .proc_read    = seq_read,
+    .proc_lseek   = seq_lseek,
+    .proc_release = seq_release_private,
+};
+
+static int __init metrics_prom_init(void)
+{
+    if (!proc_create("202000173_metrics", 0444, NULL, &metrics_prom_ops))
+        return -ENOMEM;
+    return 0;
+}
+late_initcall(metrics_prom_init);
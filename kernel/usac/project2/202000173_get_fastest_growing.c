@@ -0,0 +1,95 @@
+#include <linux/kernel.h>
+#include <linux/syscalls.h>   // Para SYSCALL_DEFINE, definir nuevas syscalls
+#include <linux/uaccess.h>    // copy_to_user
+#include <linux/slab.h>
+
+#include "202000173_growth_tracker.h"
+
+#define FASTEST_GROWING_MAX 256
+
+static s64 growth_key(const struct growth_info *info, unsigned int sort_by)
+{
+	return sort_by == GROWTH_SORT_VM ? info->vm_slope : info->rss_slope;
+}
+
+/*
+ * Inserta info en top (de mayor a menor pendiente según sort_by, *count
+ * elementos y capacidad max).
+ */
+static void growth_rank_insert(struct growth_info *top, unsigned int *count, unsigned int max,
+			       const struct growth_info *info, unsigned int sort_by)
+{
+	s64 slope = growth_key(info, sort_by);
+	unsigned int i = *count;
+
+	if (i == max) {
+		if (slope <= growth_key(&top[max - 1], sort_by))
+			return;
+		i = max - 1;
+	} else {
+		(*count)++;
+	}
+
+	while (i > 0 && growth_key(&top[i - 1], sort_by) < slope) {
+		top[i] = top[i - 1];
+		i--;
+	}
+	top[i] = *info;
+}
+
+/*
+ * Syscall: _202000173_get_fastest_growing
+ *
+ * Retorna los n procesos cuya memoria crece más rápido según el historial
+ * del rastreador (syscall 574), ordenados por pendiente de RSS o de memoria
+ * virtual. Solo se incluyen procesos con pendiente positiva, al menos
+ * GROWTH_MIN_SAMPLES muestras y visibles en el espacio de nombres de PID del
+ * llamador.
+ * Argumentos:
+ *   - buf: Arreglo de growth_info en el espacio de usuario.
+ *   - n: Capacidad de buf (máximo FASTEST_GROWING_MAX).
+ *   - sort_by: GROWTH_SORT_RSS o GROWTH_SORT_VM.
+ *
+ * Retorno: cantidad de procesos copiados, o -ENODATA si el rastreador está detenido.
+ */
+SYSCALL_DEFINE3(_202000173_get_fastest_growing, struct growth_info __user *, user_buf,
+		unsigned int, n, unsigned int, sort_by)
+{
+	struct growth_info *top, info;
+	struct growth_entry *entry;
+	unsigned int count = 0;
+	pid_t vpid;
+	long ret;
+	int bkt;
+
+	if (n == 0 || n > FASTEST_GROWING_MAX)
+		return -EINVAL;
+	if (sort_by != GROWTH_SORT_RSS && sort_by != GROWTH_SORT_VM)
+		return -EINVAL;
+	if (!growth_tracker_interval())
+		return -ENODATA;
+
+	top = kmalloc_array(n, sizeof(*top), GFP_KERNEL);
+	if (!top)
+		return -ENOMEM;
+
+	mutex_lock(&growth_lock);
+	hash_for_each(growth_table, bkt, entry, node) {
+		// Los procesos fuera del espacio de nombres de PID del llamador no se reportan
+		vpid = growth_entry_vpid(entry);
+		if (!vpid || !growth_fill_info(entry, &info))
+			continue;
+		info.pid = vpid;
+		if (growth_key(&info, sort_by) <= 0)
+			continue;
+		growth_rank_insert(top, &count, n, &info, sort_by);
+	}
+	mutex_unlock(&growth_lock);
+
+	ret = count;
+	if (copy_to_user(user_buf, top, count * sizeof(*top)))
+		ret = -EFAULT;
+
+	kfree(top);
+	return ret;
+}
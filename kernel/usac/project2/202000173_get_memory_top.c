@@ -0,0 +1,243 @@
+#include <linux/kernel.h>
+#include <linux/syscalls.h>   // Para SYSCALL_DEFINE, definir nuevas syscalls
+#include <linux/uaccess.h>    // copy_to_user
+#include <linux/oom.h>        // find_lock_task_mm
+#include <linux/mm.h>         // si_meminfo, si_mem_available, get_mm_rss, get_mm_counter
+#include <linux/swap.h>       // si_swapinfo
+#include <linux/vmstat.h>     // global_node_page_state
+#include <linux/sched.h>
+#include <linux/sched/signal.h>
+#include <linux/sched/stat.h> // nr_threads, nr_running
+#include <linux/cred.h>       // task_uid
+#include <linux/rcupdate.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+#include <linux/ktime.h>
+
+#include "202000173_growth_tracker.h"
+
+#define MEMORY_TOP_MAX 1024
+
+/* Criterio de orden */
+#define MEMORY_TOP_SORT_RSS     0
+#define MEMORY_TOP_SORT_VM      1
+#define MEMORY_TOP_SORT_GROWTH  2
+
+/* flags de memory_top_proc */
+#define MEMORY_TOP_HAS_GROWTH   0x1   /* rss_slope y vm_slope vienen del rastreador */
+
+/*
+ * Agregados globales de una consulta; todos los tamaños en bytes.
+ *   - sum_rss, sum_vm, sum_swap: suma sobre los procesos de usuario
+ *     visibles desde el espacio de nombres de PID del llamador
+ *     (nr_processes), del mismo recorrido que llena la tabla.
+ *   - growth_interval_ms: intervalo del rastreador (syscall 574), 0 si está
+ *     detenido; nr_growing cuenta los procesos con pendiente de RSS positiva.
+ */
+struct memory_top_global {
+	__u64 timestamp_ns;
+	__u64 total_ram;
+	__u64 free_ram;
+	__u64 available_ram;
+	__u64 cache_ram;
+	__u64 buffer_ram;
+	__u64 shmem_ram;
+	__u64 swap_total;
+	__u64 swap_free;
+	__u64 sum_rss;
+	__u64 sum_vm;
+	__u64 sum_swap;
+	__u32 nr_processes;
+	__u32 nr_threads;
+	__u32 nr_running;
+	__u32 nr_growing;
+	__u32 growth_interval_ms;
+	__u32 reserved;
+};
+
+/* Fila de la tabla por proceso; pid en el espacio de nombres del llamador */
+struct memory_top_proc {
+	__s32 pid;
+	__u32 uid;
+	__s32 oom_score_adj;
+	__u32 flags;
+	char  comm[16];
+	__u64 rss_bytes;
+	__u64 vm_bytes;
+	__u64 swap_bytes;
+	__s64 rss_slope;   /* bytes por segundo */
+	__s64 vm_slope;
+};
+
+static s64 memory_top_key(const struct memory_top_proc *info, unsigned int sort_by)
+{
+	switch (sort_by) {
+	case MEMORY_TOP_SORT_VM:
+		return info->vm_bytes;
+	case MEMORY_TOP_SORT_GROWTH:
+		return info->rss_slope;
+	default:
+		return info->rss_bytes;
+	}
+}
+
+/*
+ * Inserta info en top (de mayor a menor según sort_by, *count elementos y
+ * capacidad max).
+ */
+static void memory_top_insert(struct memory_top_proc *top, unsigned int *count, unsigned int max,
+			      const struct memory_top_proc *info, unsigned int sort_by)
+{
+	s64 key = memory_top_key(info, sort_by);
+	unsigned int i = *count;
+
+	// El llamador ya descartó los que no superan al último
+	if (i == max)
+		i = max - 1;
+	else
+		(*count)++;
+
+	while (i > 0 && memory_top_key(&top[i - 1], sort_by) < key) {
+		top[i] = top[i - 1];
+		i--;
+	}
+	top[i] = *info;
+}
+
+static void memory_top_fill_global(struct memory_top_global *global)
+{
+	struct sysinfo i;
+	unsigned long file_pages, shmem;
+
+	si_meminfo(&i);
+	si_swapinfo(&i);
+	file_pages = global_node_page_state(NR_FILE_PAGES);
+	shmem = global_node_page_state(NR_SHMEM);
+
+	// Mismo cálculo de caché que la syscall 548
+	global->total_ram     = (u64)i.totalram * PAGE_SIZE;
+	global->free_ram      = (u64)i.freeram * PAGE_SIZE;
+	global->available_ram = (u64)si_mem_available() * PAGE_SIZE;
+	global->cache_ram     = (u64)(file_pages - shmem - i.bufferram) * PAGE_SIZE;
+	global->buffer_ram    = (u64)i.bufferram * PAGE_SIZE;
+	global->shmem_ram     = (u64)shmem * PAGE_SIZE;
+	global->swap_total    = (u64)i.totalswap * PAGE_SIZE;
+	global->swap_free     = (u64)i.freeswap * PAGE_SIZE;
+	global->nr_threads    = nr_threads;
+	global->nr_running    = nr_running();
+}
+
+/*
+ * Syscall: _202000173_get_memory_top
+ *
+ * Consulta por lotes para un monitor tipo top: en una sola llamada llena los
+ * agregados globales de memoria y retorna los n procesos con mayor RSS,
+ * memoria virtual o pendiente de crecimiento, en una sola pasada por la
+ * lista de procesos. Si el rastreador de crecimiento (syscall 574) está
+ * activo, cada fila trae además su pendiente; la columna de crecimiento no
+ * cuesta una segunda consulta.
+ * Argumentos:
+ *   - global: Estructura memory_top_global en el espacio de usuario.
+ *   - buf: Arreglo de memory_top_proc; puede ser NULL si n es 0.
+ *   - n: Capacidad de buf (máximo MEMORY_TOP_MAX).
+ *   - sort_by: MEMORY_TOP_SORT_RSS, MEMORY_TOP_SORT_VM o MEMORY_TOP_SORT_GROWTH.
+ *
+ * Retorno: cantidad de procesos copiados a buf, o -ENODATA si se pide orden
+ * por crecimiento con el rastreador detenido.
+ */
+SYSCALL_DEFINE4(_202000173_get_memory_top, struct memory_top_global __user *, user_global,
+		struct memory_top_proc __user *, user_buf, unsigned int, n, unsigned int, sort_by)
+{
+	struct memory_top_global global;
+	struct memory_top_proc *top = NULL, info;
+	struct growth_info growth;
+	struct growth_entry *entry;
+	struct task_struct *p, *t;
+	unsigned int count = 0;
+	bool tracking;
+	pid_t vpid;
+	long ret;
+
+	if (!user_global || n > MEMORY_TOP_MAX)
+		return -EINVAL;
+	if (sort_by > MEMORY_TOP_SORT_GROWTH)
+		return -EINVAL;
+
+	memset(&global, 0, sizeof(global));
+	global.growth_interval_ms = growth_tracker_interval();
+	tracking = global.growth_interval_ms != 0;
+	if (sort_by == MEMORY_TOP_SORT_GROWTH && !tracking)
+		return -ENODATA;
+
+	if (n) {
+		top = kmalloc_array(n, sizeof(*top), GFP_KERNEL);
+		if (!top)
+			return -ENOMEM;
+	}
+
+	memory_top_fill_global(&global);
+
+	// growth_lock es un mutex: se toma antes de entrar a la sección RCU
+	if (tracking)
+		mutex_lock(&growth_lock);
+	rcu_read_lock();
+	for_each_process(p) {
+		if (p->flags & PF_KTHREAD)
+			continue;
+		// 0: el proceso no es visible desde el espacio de nombres del llamador
+		vpid = task_tgid_vnr(p);
+		if (!vpid)
+			continue;
+
+		t = find_lock_task_mm(p);
+		if (!t)
+			continue;
+		memset(&info, 0, sizeof(info));
+		info.rss_bytes     = (u64)get_mm_rss(t->mm) * PAGE_SIZE;
+		info.vm_bytes      = (u64)t->mm->total_vm * PAGE_SIZE;
+		info.swap_bytes    = (u64)get_mm_counter(t->mm, MM_SWAPENTS) * PAGE_SIZE;
+		info.oom_score_adj = t->signal->oom_score_adj;
+		task_unlock(t);
+
+		info.pid = vpid;
+		if (tracking) {
+			// El rastreador indexa por el tgid global
+			entry = growth_lookup(task_tgid_nr(p), p->start_time);
+			if (entry && growth_fill_info(entry, &growth)) {
+				info.rss_slope = growth.rss_slope;
+				info.vm_slope  = growth.vm_slope;
+				info.flags |= MEMORY_TOP_HAS_GROWTH;
+				if (growth.rss_slope > 0)
+					global.nr_growing++;
+			}
+		}
+
+		global.nr_processes++;
+		global.sum_rss  += info.rss_bytes;
+		global.sum_vm   += info.vm_bytes;
+		global.sum_swap += info.swap_bytes;
+
+		// Solo se completan las filas que entran a la tabla
+		if (!n)
+			continue;
+		if (count == n && memory_top_key(&info, sort_by) <= memory_top_key(&top[n - 1], sort_by))
+			continue;
+		info.uid = from_kuid_munged(current_user_ns(), task_uid(p));
+		get_task_comm(info.comm, p);
+		memory_top_insert(top, &count, n, &info, sort_by);
+	}
+	rcu_read_unlock();
+	if (tracking)
+		mutex_unlock(&growth_lock);
+
+	global.timestamp_ns = ktime_get_boottime_ns();
+
+	ret = count;
+	if (copy_to_user(user_global, &global, sizeof(global)))
+		ret = -EFAULT;
+	else if (count && copy_to_user(user_buf, top, count * sizeof(*top)))
+		ret = -EFAULT;
+
+	kfree(top);
+	return ret;
+}
@@ -0,0 +1,131 @@
+#include <linux/kernel.h>
+#include <linux/syscalls.h>   // Para SYSCALL_DEFINE, definir nuevas syscalls
+#include <linux/uaccess.h>    // copy_to_user
+#include <linux/oom.h>        // oom_badness, find_lock_task_mm
+#include <linux/mm.h>         // get_mm_rss, get_mm_counter, mm_pgtables_bytes
+#include <linux/swap.h>       // total_swap_pages
+#include <linux/sched.h>
+#include <linux/sched/signal.h>
+#include <linux/rcupdate.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+
+#define OOM_RANKING_MAX 256
+
+/*
+ * Estructura que se copia al espacio de usuario, una por proceso, ordenadas
+ * de la próxima víctima del OOM killer a la menos probable.
+ *   - points: valor que usa el OOM killer (oom_badness), en páginas.
+ *   - oom_score: el mismo valor escalado como /proc/pid/oom_score (0-2000).
+ *   - rss_pages, swap_pages, pgtable_pages: componentes de points antes del
+ *     ajuste por oom_score_adj.
+ */
+struct oom_rank_info {
+	__s32 pid;
+	__s32 oom_score_adj;
+	char  comm[16];
+	__s64 points;
+	__u64 oom_score;
+	__u64 rss_pages;
+	__u64 swap_pages;
+	__u64 pgtable_pages;
+};
+
+/*
+ * Inserta info en top (de mayor a menor points, *count elementos y capacidad
+ * max). Retorna la posición o -1 si no entra.
+ */
+static int oom_rank_insert(struct oom_rank_info *top, unsigned int *count, unsigned int max,
+			   const struct oom_rank_info *info)
+{
+	unsigned int i = *count;
+
+	if (i == max) {
+		if (info->points <= top[max - 1].points)
+			return -1;
+		i = max - 1;
+	} else {
+		(*count)++;
+	}
+
+	while (i > 0 && top[i - 1].points < info->points) {
+		top[i] = top[i - 1];
+		i--;
+	}
+	top[i] = *info;
+	return i;
+}
+
+/*
+ * Syscall: _202000173_get_oom_ranking
+ *
+ * Calcula oom_badness() para cada proceso elegible en una sola pasada y
+ * retorna los n con mayor puntaje, es decir, el orden en que el OOM killer
+ * global elegiría víctimas. Se usa el mismo totalpages que /proc/pid/oom_score
+ * (RAM + swap). Los componentes se leen solo para los procesos que entran al
+ * top, con el mismo task_lock que toma oom_badness. Solo se incluyen los
+ * procesos visibles en el espacio de nombres de PID del llamador, con su PID
+ * en ese espacio.
+ *
+ * Retorno: cantidad de procesos copiados.
+ */
+SYSCALL_DEFINE2(_202000173_get_oom_ranking, struct oom_rank_info __user *, user_buf, unsigned int, n)
+{
+	unsigned long totalpages = totalram_pages() + total_swap_pages;
+	struct oom_rank_info *top, info;
+	struct task_struct *p, *t;
+	unsigned int count = 0;
+	pid_t pid;
+	long points;
+	long ret;
+
+	if (n == 0 || n > OOM_RANKING_MAX)
+		return -EINVAL;
+
+	top = kmalloc_array(n, sizeof(*top), GFP_KERNEL);
+	if (!top)
+		return -ENOMEM;
+
+	rcu_read_lock();
+	for_each_process(p) {
+		// Mismos procesos que oom_unkillable_task() descarta
+		if (is_global_init(p) || (p->flags & PF_KTHREAD))
+			continue;
+		// 0: el proceso no es visible desde el espacio de nombres del llamador
+		pid = task_tgid_vnr(p);
+		if (!pid)
+			continue;
+
+		// LONG_MIN: OOM_SCORE_ADJ_MIN, MMF_OOM_SKIP, vfork o sin mm
+		points = oom_badness(p, totalpages);
+		if (points == LONG_MIN)
+			continue;
+		if (count == n && points <= top[n - 1].points)
+			continue;
+
+		memset(&info, 0, sizeof(info));
+		info.pid = pid;
+		info.points = points;
+		info.oom_score = (1000 + points * 1000 / (long)totalpages) * 2 / 3;
+
+		t = find_lock_task_mm(p);
+		if (!t)
+			continue;
+		info.oom_score_adj = t->signal->oom_score_adj;
+		info.rss_pages     = get_mm_rss(t->mm);
+		info.swap_pages    = get_mm_counter(t->mm, MM_SWAPENTS);
+		info.pgtable_pages = mm_pgtables_bytes(t->mm) / PAGE_SIZE;
+		task_unlock(t);
+		get_task_comm(info.comm, p);
+
+		oom_rank_insert(top, &count, n, &info);
+	}
+	rcu_read_unlock();
+
+	ret = count;
+	if (copy_to_user(user_buf, top, count * sizeof(*top)))
+		ret = -EFAULT;
+
+	kfree(top);
+	return ret;
+}
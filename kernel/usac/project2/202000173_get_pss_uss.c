@@ -0,0 +1,399 @@
+#include <linux/kernel.h>
+#include <linux/syscalls.h>   // Para SYSCALL_DEFINE, definir nuevas syscalls
+#include <linux/uaccess.h>    // copy_from_user, copy_to_user
+#include <linux/mm.h>         // vm_normal_page, page_mapcount, contadores RSS
+#include <linux/huge_mm.h>    // pmd_trans_huge_lock
+#include <linux/pagewalk.h>   // walk_page_range
+#include <linux/sched.h>
+#include <linux/sched/mm.h>   // get_task_mm, mmgrab, mmdrop
+#include <linux/sched/task.h>
+#include <linux/pid.h>
+#include <linux/ptrace.h>     // ptrace_may_access
+#include <linux/slab.h>
+#include <linux/hashtable.h>
+#include <linux/mutex.h>
+#include <linux/jiffies.h>
+#include <linux/math64.h>
+
+/*
+ * Syscall: _202000173_get_pss_uss
+ *
+ * PSS (cada página dividida entre los procesos que la mapean) y USS (páginas
+ * mapeadas solo por este proceso) para una lista de PIDs, con el mismo
+ * criterio que /proc/pid/smaps_rollup.
+ *
+ * Para no recorrer las tablas de páginas en cada consulta, el resultado de
+ * cada VMA se guarda en un cache por mm. Al consultar de nuevo:
+ *   - Si la VMA tiene los mismos límites, flags, archivo y secuencia de lock,
+ *     y los contadores RSS de los que depende (anon, file, shmem) no
+ *     cambiaron, se reutiliza su resultado.
+ *   - Si no, solo esa VMA se vuelve a recorrer.
+ * Un proceso estable se responde sin tocar sus tablas de páginas.
+ *
+ * Los contadores RSS no ven cambios que se compensan (una página que entra y
+ * otra que sale) ni cambios en cuántos otros procesos mapean una página
+ * compartida; por eso ninguna entrada se reutiliza después de
+ * PSS_CACHE_MAX_AGE, y PSS_USS_NOCACHE fuerza un recorrido completo.
+ */
+#define PSS_SHIFT            12                 // Igual que fs/proc/task_mmu.c
+#define PSS_USS_MAX_PIDS     4096
+#define PSS_CACHE_MAX_MMS    1024
+#define PSS_CACHE_MAX_AGE    (5 * 60 * HZ)
+#define PSS_USS_NOCACHE      0x1
+
+/* Dependencias de una VMA respecto a los contadores RSS del mm */
+#define PSS_DEP_ANON   (1 << MM_ANONPAGES)
+#define PSS_DEP_FILE   (1 << MM_FILEPAGES)
+#define PSS_DEP_SHMEM  (1 << MM_SHMEMPAGES)
+
+/*
+ * Estructura que se copia al espacio de usuario, una por PID.
+ */
+struct pss_uss_info {
+	__s32 pid;
+	__s32 status;          // 0, -ESRCH (no existe), -EINVAL (sin memoria) o
+	                       // -EACCES (sin permiso de lectura, como smaps_rollup)
+	__u64 rss_kb;
+	__u64 pss_kb;
+	__u64 uss_kb;
+	__u32 vmas_walked;     // VMAs cuyas tablas de páginas se recorrieron
+	__u32 vmas_cached;     // VMAs respondidas desde el cache
+};
+
+/* Resultado cacheado de una VMA y los datos que la identifican */
+struct pss_vma_cache {
+	unsigned long start;
+	unsigned long end;
+	unsigned long pgoff;
+	vm_flags_t flags;
+	struct file *file;     // Solo se compara, nunca se desreferencia
+#ifdef CONFIG_PER_VMA_LOCK
+	int lock_seq;
+#endif
+	u8 deps;
+	u64 rss;
+	u64 pss;               // Desplazado PSS_SHIFT bits, como en smaps
+	u64 uss;
+};
+
+/*
+ * Cache de un mm. mmgrab mantiene vivo el mm_struct para que su dirección
+ * no se reutilice con otro proceso mientras la entrada existe.
+ */
+struct pss_mm_cache {
+	struct mm_struct *mm;
+	unsigned long counters[NR_MM_COUNTERS];
+	unsigned long refreshed;       // jiffies del último recorrido completo
+	unsigned int nr_vmas;
+	struct pss_vma_cache *vmas;
+	struct hlist_node hnode;
+	struct list_head lru;
+};
+
+static DEFINE_HASHTABLE(pss_cache, 8);
+static LIST_HEAD(pss_cache_lru);           // Más reciente al inicio
+static unsigned int pss_cache_nr;
+static DEFINE_MUTEX(pss_cache_lock);       // Protege todo el cache
+
+struct pss_acc {
+	u64 rss;
+	u64 pss;
+	u64 uss;
+};
+
+static void pss_account(struct pss_acc *acc, struct page *page, unsigned long size)
+{
+	int mapcount = page_mapcount(page);
+
+	acc->rss += size;
+	if (mapcount >= 2) {
+		acc->pss += div_u64((u64)size << PSS_SHIFT, mapcount);
+	} else {
+		acc->pss += (u64)size << PSS_SHIFT;
+		acc->uss += size;
+	}
+}
+
+/*
+ * Igual que smaps_pte_range: un THP mapeado con PMD se cuenta completo sin
+ * dividirlo; el resto se recorre PTE por PTE.
+ */
+static int pss_pmd_entry(pmd_t *pmd, unsigned long addr, unsigned long end, struct mm_walk *walk)
+{
+	struct pss_acc *acc = walk->private;
+	struct page *page;
+	spinlock_t *ptl;
+	pte_t *start_pte, *pte;
+	pte_t ptent;
+
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	ptl = pmd_trans_huge_lock(pmd, walk->vma);
+	if (ptl) {
+		if (pmd_present(*pmd)) {
+			page = vm_normal_page_pmd(walk->vma, addr, *pmd);
+			if (page)
+				pss_account(acc, page, HPAGE_PMD_SIZE);
+		}
+		spin_unlock(ptl);
+		return 0;
+	}
+#endif
+
+	start_pte = pte = pte_offset_map_lock(walk->mm, pmd, addr, &ptl);
+	if (!pte) {
+		walk->action = ACTION_AGAIN;
+		return 0;
+	}
+	for (; addr != end; pte++, addr += PAGE_SIZE) {
+		ptent = ptep_get(pte);
+		if (!pte_present(ptent))
+			continue;
+		page = vm_normal_page(walk->vma, addr, ptent);
+		if (page)
+			pss_account(acc, page, PAGE_SIZE);
+	}
+	pte_unmap_unlock(start_pte, ptl);
+	cond_resched();
+	return 0;
+}
+
+static const struct mm_walk_ops pss_walk_ops = {
+	.pmd_entry = pss_pmd_entry,
+	.walk_lock = PGWALK_RDLOCK,
+};
+
+/* Contadores RSS de los que depende el resultado de una VMA */
+static u8 pss_vma_deps(struct vm_area_struct *vma)
+{
+	if (vma_is_shmem(vma))
+		return PSS_DEP_SHMEM;
+	if (vma->vm_file && !vma->anon_vma)
+		return PSS_DEP_FILE;
+	// Anónima, o archivo privado con páginas copiadas (COW)
+	return PSS_DEP_ANON | (vma->vm_file ? PSS_DEP_FILE : 0);
+}
+
+static void pss_vma_identity(struct pss_vma_cache *c, struct vm_area_struct *vma)
+{
+	c->start = vma->vm_start;
+	c->end   = vma->vm_end;
+	c->pgoff = vma->vm_pgoff;
+	c->flags = vma->vm_flags;
+	c->file  = vma->vm_file;
+#ifdef CONFIG_PER_VMA_LOCK
+	c->lock_seq = READ_ONCE(vma->vm_lock_seq);
+#endif
+	c->deps  = pss_vma_deps(vma);
+}
+
+static bool pss_vma_same(const struct pss_vma_cache *a, const struct pss_vma_cache *b)
+{
+	return a->start == b->start && a->end == b->end && a->pgoff == b->pgoff &&
+	       a->flags == b->flags && a->file == b->file &&
+#ifdef CONFIG_PER_VMA_LOCK
+	       a->lock_seq == b->lock_seq &&
+#endif
+	       a->deps == b->deps;
+}
+
+static void pss_cache_free(struct pss_mm_cache *cache)
+{
+	hash_del(&cache->hnode);
+	list_del(&cache->lru);
+	pss_cache_nr--;
+	mmdrop(cache->mm);
+	kvfree(cache->vmas);
+	kfree(cache);
+}
+
+/* Descarta los mm de procesos que ya terminaron. Requiere pss_cache_lock. */
+static void pss_cache_prune(void)
+{
+	struct pss_mm_cache *cache, *tmp;
+
+	list_for_each_entry_safe(cache, tmp, &pss_cache_lru, lru) {
+		if (!atomic_read(&cache->mm->mm_users))
+			pss_cache_free(cache);
+	}
+}
+
+static struct pss_mm_cache *pss_cache_get(struct mm_struct *mm)
+{
+	struct pss_mm_cache *cache;
+
+	hash_for_each_possible(pss_cache, cache, hnode, (unsigned long)mm) {
+		if (cache->mm == mm) {
+			list_move(&cache->lru, &pss_cache_lru);
+			return cache;
+		}
+	}
+
+	if (pss_cache_nr >= PSS_CACHE_MAX_MMS)
+		pss_cache_free(list_last_entry(&pss_cache_lru, struct pss_mm_cache, lru));
+
+	cache = kzalloc(sizeof(*cache), GFP_KERNEL);
+	if (!cache)
+		return NULL;
+	mmgrab(mm);
+	cache->mm = mm;
+	hash_add(pss_cache, &cache->hnode, (unsigned long)mm);
+	list_add(&cache->lru, &pss_cache_lru);
+	pss_cache_nr++;
+	return cache;
+}
+
+/*
+ * Calcula PSS/USS de mm reutilizando las VMAs que no cambiaron. Las VMAs del
+ * cache están ordenadas por dirección igual que las del mm, así que se
+ * emparejan avanzando un cursor. Requiere pss_cache_lock.
+ */
+static int pss_mm_compute(struct mm_struct *mm, struct pss_uss_info *info, unsigned int flags)
+{
+	struct pss_mm_cache *cache;
+	struct pss_vma_cache *vmas, *old, cur;
+	struct vm_area_struct *vma;
+	unsigned long counters[NR_MM_COUNTERS];
+	unsigned int nr, i, cursor = 0;
+	struct pss_acc acc;
+	u64 pss = 0;
+	u8 changed = 0;
+	bool expired;
+
+	cache = pss_cache_get(mm);
+	if (!cache)
+		return -ENOMEM;
+
+	if (mmap_read_lock_killable(mm))
+		return -EINTR;
+
+	// Suma exacta: el valor aproximado de los contadores por CPU esconde cambios pequeños
+	for (i = 0; i < NR_MM_COUNTERS; i++) {
+		counters[i] = percpu_counter_sum_positive(&mm->rss_stat[i]);
+		if (counters[i] != cache->counters[i])
+			changed |= 1 << i;
+	}
+	expired = (flags & PSS_USS_NOCACHE) || !cache->vmas ||
+		  time_after(jiffies, cache->refreshed + PSS_CACHE_MAX_AGE);
+
+	vmas = kvmalloc_array(mm->map_count, sizeof(*vmas), GFP_KERNEL);
+	if (!vmas) {
+		mmap_read_unlock(mm);
+		return -ENOMEM;
+	}
+
+	nr = 0;
+	{
+		VMA_ITERATOR(vmi, mm, 0);
+
+		for_each_vma(vmi, vma) {
+			if (nr >= mm->map_count)
+				break;
+			pss_vma_identity(&cur, vma);
+
+			while (cursor < cache->nr_vmas && cache->vmas[cursor].end <= cur.start)
+				cursor++;
+			old = cursor < cache->nr_vmas ? &cache->vmas[cursor] : NULL;
+
+			if (!expired && old && pss_vma_same(old, &cur) && !(old->deps & changed)) {
+				cur.rss = old->rss;
+				cur.pss = old->pss;
+				cur.uss = old->uss;
+				info->vmas_cached++;
+			} else {
+				memset(&acc, 0, sizeof(acc));
+				walk_page_range(mm, vma->vm_start, vma->vm_end, &pss_walk_ops, &acc);
+				cur.rss = acc.rss;
+				cur.pss = acc.pss;
+				cur.uss = acc.uss;
+				info->vmas_walked++;
+			}
+
+			vmas[nr++] = cur;
+			info->rss_kb += cur.rss >> 10;
+			info->uss_kb += cur.uss >> 10;
+			pss += cur.pss;
+		}
+	}
+	mmap_read_unlock(mm);
+
+	info->pss_kb = pss >> (PSS_SHIFT + 10);
+
+	kvfree(cache->vmas);
+	cache->vmas = vmas;
+	cache->nr_vmas = nr;
+	memcpy(cache->counters, counters, sizeof(counters));
+	if (expired)
+		cache->refreshed = jiffies;
+	return 0;
+}
+
+/*
+ * Argumentos:
+ *   - pids: Arreglo de PIDs en el espacio de usuario.
+ *   - info: Arreglo de salida con una entrada por PID.
+ *   - count: Cantidad de PIDs (máximo PSS_USS_MAX_PIDS).
+ *   - flags: PSS_USS_NOCACHE para ignorar el cache.
+ *
+ * Retorno: count si tiene éxito (el estado de cada PID va en info[i].status).
+ */
+SYSCALL_DEFINE4(_202000173_get_pss_uss, const pid_t __user *, pids, struct pss_uss_info __user *, info,
+		unsigned int, count, unsigned int, flags)
+{
+	struct pss_uss_info *out;
+	struct task_struct *task;
+	struct mm_struct *mm;
+	pid_t *kpids;
+	unsigned int i;
+	long ret;
+
+	if (!count || count > PSS_USS_MAX_PIDS || (flags & ~PSS_USS_NOCACHE))
+		return -EINVAL;
+
+	kpids = memdup_user(pids, count * sizeof(*kpids));
+	if (IS_ERR(kpids))
+		return PTR_ERR(kpids);
+
+	out = kvcalloc(count, sizeof(*out), GFP_KERNEL);
+	if (!out) {
+		kfree(kpids);
+		return -ENOMEM;
+	}
+
+	mutex_lock(&pss_cache_lock);
+	pss_cache_prune();
+	for (i = 0; i < count; i++) {
+		out[i].pid = kpids[i];
+
+		task = get_pid_task(find_vpid(kpids[i]), PIDTYPE_PID);
+		if (!task) {
+			out[i].status = -ESRCH;
+			continue;
+		}
+		// Mismo permiso que /proc/pid/smaps_rollup
+		if (!ptrace_may_access(task, PTRACE_MODE_READ_FSCREDS)) {
+			put_task_struct(task);
+			out[i].status = -EACCES;
+			continue;
+		}
+		mm = get_task_mm(task);
+		put_task_struct(task);
+		if (!mm) {
+			out[i].status = -EINVAL;   // Hilo del kernel o proceso terminando
+			continue;
+		}
+
+		out[i].status = pss_mm_compute(mm, &out[i], flags);
+		mmput(mm);
+		if (out[i].status == -EINTR)
+			break;
+	}
+	mutex_unlock(&pss_cache_lock);
+
+	ret = i < count ? -EINTR : count;
+	if (ret > 0 && copy_to_user(info, out, count * sizeof(*out)))
+		ret = -EFAULT;
+
+	kvfree(out);
+	kfree(kpids);
+	return ret;
+}
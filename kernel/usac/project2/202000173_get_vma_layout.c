@@ -0,0 +1,260 @@
+#include <linux/kernel.h>
+#include <linux/syscalls.h>   // Para SYSCALL_DEFINE, definir nuevas syscalls
+#include <linux/uaccess.h>    // copy_to_user
+#include <linux/mm.h>         // vm_area_struct, VMA_ITERATOR
+#include <linux/huge_mm.h>    // pmd_trans_huge_lock
+#include <linux/pagewalk.h>   // walk_page_range
+#include <linux/ptrace.h>     // ptrace_may_access
+#include <linux/sched.h>
+#include <linux/sched/mm.h>   // get_task_mm, mmput
+#include <linux/sched/task.h>
+#include <linux/pid.h>
+#include <linux/slab.h>
+
+/*
+ * Syscall: _202000173_get_vma_layout
+ *
+ * Resumen binario del espacio de direcciones de un proceso, una alternativa
+ * a parsear /proc/pid/maps. Se recorre el maple tree del mm bajo
+ * mmap_read_lock en bloques de VMA_LAYOUT_CHUNK registros; entre bloques se
+ * suelta el lock y se copian los registros al usuario, así que un proceso con
+ * cientos de miles de VMAs nunca bloquea sus propios mmap/fallos de página
+ * durante todo el recorrido.
+ */
+#define VMA_LAYOUT_CHUNK      1024
+
+/* Flags de la syscall */
+#define VMA_LAYOUT_MERGE      0x1   // Fusiona VMAs contiguas del mismo tipo, permisos y archivo
+#define VMA_LAYOUT_RESIDENT   0x2   // Cuenta páginas residentes (recorre tablas de páginas)
+#define VMA_LAYOUT_VALID      (VMA_LAYOUT_MERGE | VMA_LAYOUT_RESIDENT)
+
+/* Permisos de cada registro */
+#define VMA_LAYOUT_R          0x01
+#define VMA_LAYOUT_W          0x02
+#define VMA_LAYOUT_X          0x04
+#define VMA_LAYOUT_SHARED     0x08
+#define VMA_LAYOUT_LOCKED     0x10
+#define VMA_LAYOUT_HUGETLB    0x20
+
+/* Tipo de mapeo */
+enum vma_layout_type {
+	VMA_LAYOUT_ANON,
+	VMA_LAYOUT_FILE,
+	VMA_LAYOUT_HEAP,
+	VMA_LAYOUT_STACK,
+	VMA_LAYOUT_SPECIAL,    // vdso, vvar, mapeos de I/O o PFN
+};
+
+/*
+ * Estructura que se copia al espacio de usuario, un registro por VMA (o por
+ * grupo de VMAs fusionadas con VMA_LAYOUT_MERGE).
+ */
+struct vma_layout_record {
+	__u64 start;
+	__u64 end;
+	__u32 flags;
+	__u32 type;
+	__u64 resident_pages;  // Solo con VMA_LAYOUT_RESIDENT
+	__u32 nr_vmas;         // VMAs que cubre el registro
+	__u32 reserved;
+};
+
+static int vma_layout_pmd_entry(pmd_t *pmd, unsigned long addr, unsigned long end,
+				struct mm_walk *walk)
+{
+	u64 *resident = walk->private;
+	spinlock_t *ptl;
+	pte_t *start_pte, *pte;
+
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	ptl = pmd_trans_huge_lock(pmd, walk->vma);
+	if (ptl) {
+		if (pmd_present(*pmd))
+			*resident += HPAGE_PMD_NR;
+		spin_unlock(ptl);
+		return 0;
+	}
+#endif
+
+	start_pte = pte = pte_offset_map_lock(walk->mm, pmd, addr, &ptl);
+	if (!pte) {
+		walk->action = ACTION_AGAIN;
+		return 0;
+	}
+	for (; addr != end; pte++, addr += PAGE_SIZE) {
+		if (pte_present(ptep_get(pte)))
+			(*resident)++;
+	}
+	pte_unmap_unlock(start_pte, ptl);
+	cond_resched();
+	return 0;
+}
+
+static const struct mm_walk_ops vma_layout_walk_ops = {
+	.pmd_entry = vma_layout_pmd_entry,
+	.walk_lock = PGWALK_RDLOCK,
+};
+
+static u32 vma_layout_type(struct vm_area_struct *vma)
+{
+	struct mm_struct *mm = vma->vm_mm;
+
+	if (vma->vm_flags & (VM_IO | VM_PFNMAP) || (!vma->vm_file && vma->vm_ops))
+		return VMA_LAYOUT_SPECIAL;
+	if (vma->vm_file)
+		return VMA_LAYOUT_FILE;
+	if (vma->vm_start <= mm->brk && vma->vm_end >= mm->start_brk)
+		return VMA_LAYOUT_HEAP;
+	if (vma->vm_start <= mm->start_stack && vma->vm_end >= mm->start_stack)
+		return VMA_LAYOUT_STACK;
+	return VMA_LAYOUT_ANON;
+}
+
+static u32 vma_layout_flags(struct vm_area_struct *vma)
+{
+	u32 flags = 0;
+
+	if (vma->vm_flags & VM_READ)
+		flags |= VMA_LAYOUT_R;
+	if (vma->vm_flags & VM_WRITE)
+		flags |= VMA_LAYOUT_W;
+	if (vma->vm_flags & VM_EXEC)
+		flags |= VMA_LAYOUT_X;
+	if (vma->vm_flags & VM_MAYSHARE)
+		flags |= VMA_LAYOUT_SHARED;
+	if (vma->vm_flags & VM_LOCKED)
+		flags |= VMA_LAYOUT_LOCKED;
+	if (vma->vm_flags & VM_HUGETLB)
+		flags |= VMA_LAYOUT_HUGETLB;
+	return flags;
+}
+
+/*
+ * Argumentos:
+ *   - pid: Proceso a inspeccionar.
+ *   - start: Dirección desde la que se empieza; para continuar una lectura
+ *            se pasa el end del último registro recibido.
+ *   - buf: Arreglo de registros en el espacio de usuario.
+ *   - max: Capacidad de buf.
+ *   - flags: VMA_LAYOUT_MERGE y/o VMA_LAYOUT_RESIDENT.
+ *
+ * Retorno: cantidad de registros copiados (0 si no hay VMAs desde start).
+ * Con VMA_LAYOUT_MERGE, un grupo que cruza el límite entre bloques o entre
+ * llamadas puede quedar dividido en dos registros contiguos.
+ */
+SYSCALL_DEFINE5(_202000173_get_vma_layout, pid_t, pid, unsigned long, start,
+		struct vma_layout_record __user *, buf, unsigned int, max, unsigned int, flags)
+{
+	struct vma_layout_record *chunk, *rec;
+	struct vm_area_struct *vma;
+	struct task_struct *task;
+	struct mm_struct *mm;
+	unsigned int nr, scanned, copied = 0, chunk_size;
+	u32 type, vflags;
+	struct file *file, *last_file = NULL;
+	u64 resident;
+	bool merge, done;
+	long ret = 0;
+
+	if (!max || (flags & ~VMA_LAYOUT_VALID))
+		return -EINVAL;
+
+	task = get_pid_task(find_vpid(pid), PIDTYPE_PID);
+	if (!task)
+		return -ESRCH;
+	// Mismo permiso que /proc/pid/maps
+	if (!ptrace_may_access(task, PTRACE_MODE_READ_FSCREDS)) {
+		put_task_struct(task);
+		return -EACCES;
+	}
+	mm = get_task_mm(task);
+	put_task_struct(task);
+	if (!mm)
+		return -EINVAL;
+
+	chunk_size = min(max, (unsigned int)VMA_LAYOUT_CHUNK);
+	chunk = kvmalloc_array(chunk_size, sizeof(*chunk), GFP_KERNEL);
+	if (!chunk) {
+		mmput(mm);
+		return -ENOMEM;
+	}
+
+	while (copied < max) {
+		if (mmap_read_lock_killable(mm)) {
+			ret = -EINTR;
+			break;
+		}
+
+		/*
+		 * Se llena un bloque con el lock tomado. Los registros se copian
+		 * después de soltarlo: copy_to_user puede fallar de página y, si el
+		 * proceso inspeccionado es el mismo que llama, tomar mmap_lock otra vez.
+		 */
+		nr = 0;
+		scanned = 0;
+		{
+			VMA_ITERATOR(vmi, mm, start);
+
+			for_each_vma(vmi, vma) {
+				// Con MERGE un bloque puede cubrir muchas VMAs: también se corta por VMAs vistas
+				if (scanned++ == VMA_LAYOUT_CHUNK)
+					break;
+
+				type = vma_layout_type(vma);
+				vflags = vma_layout_flags(vma);
+				file = vma->vm_file;
+
+				rec = nr ? &chunk[nr - 1] : NULL;
+				merge = (flags & VMA_LAYOUT_MERGE) && rec && rec->end == vma->vm_start &&
+					rec->type == type && rec->flags == vflags && last_file == file;
+				if (!merge && (nr == chunk_size || copied + nr == max))
+					break;
+
+				resident = 0;
+				if (flags & VMA_LAYOUT_RESIDENT)
+					walk_page_range(mm, vma->vm_start, vma->vm_end,
+							&vma_layout_walk_ops, &resident);
+
+				if (merge) {
+					rec->end = vma->vm_end;
+					rec->resident_pages += resident;
+					rec->nr_vmas++;
+				} else {
+					rec = &chunk[nr++];
+					rec->start = vma->vm_start;
+					rec->end = vma->vm_end;
+					rec->flags = vflags;
+					rec->type = type;
+					rec->resident_pages = resident;
+					rec->nr_vmas = 1;
+					rec->reserved = 0;
+					last_file = file;
+				}
+				start = vma->vm_end;
+			}
+			done = !vma;
+		}
+		mmap_read_unlock(mm);
+
+		/*
+		 * Si el ciclo cortó antes de terminar, la VMA en la que se detuvo no
+		 * se contó: se retoma desde el final del último registro.
+		 */
+		if (!nr)
+			break;
+		start = chunk[nr - 1].end;
+
+		if (copy_to_user(buf + copied, chunk, nr * sizeof(*chunk))) {
+			ret = -EFAULT;
+			break;
+		}
+		copied += nr;
+		if (done)
+			break;
+		cond_resched();
+	}
+
+	kvfree(chunk);
+	mmput(mm);
+	return ret ? ret : copied;
+}
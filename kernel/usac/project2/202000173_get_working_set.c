@@ -0,0 +1,40 @@
+#include <linux/kernel.h>
+#include <linux/syscalls.h>   // Para SYSCALL_DEFINE, definir nuevas syscalls
+#include <linux/uaccess.h>    // copy_to_user
+
+#include "202000173_working_set.h"
+
+/*
+ * Syscall: _202000173_get_working_set
+ *
+ * Retorna la estimación del último escaneo de un proceso registrado con la
+ * syscall 569: páginas muestreadas hot (accedidas en el último intervalo),
+ * warm y cold, y su equivalente en bytes escalado al RSS del proceso.
+ *
+ * Retorno:
+ *   - 0 si tiene éxito.
+ *   - -ESRCH si el proceso no está monitoreado.
+ *   - -EFAULT si no se puede copiar al espacio de usuario.
+ */
+SYSCALL_DEFINE2(_202000173_get_working_set, pid_t, pid, struct working_set_info __user *, user_info)
+{
+	struct working_set_entry *entry;
+	struct working_set_info info;
+
+	/*
+	 * working_set_lock evita que la entrada se libere mientras se copia.
+	 */
+	mutex_lock(&working_set_lock);
+	entry = working_set_find(pid);
+	if (entry)
+		working_set_fill_info(entry, &info);
+	mutex_unlock(&working_set_lock);
+
+	if (!entry)
+		return -ESRCH;
+
+	if (copy_to_user(user_info, &info, sizeof(info)))
+		return -EFAULT;
+
+	return 0;
+}
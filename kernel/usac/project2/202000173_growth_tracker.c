@@ -0,0 +1,339 @@
+#include <linux/kernel.h>
+#include <linux/mm.h>
+#include <linux/oom.h>         // find_lock_task_mm
+#include <linux/sched.h>
+#include <linux/sched/signal.h>
+#include <linux/sched/stat.h>  // nr_processes
+#include <linux/rcupdate.h>
+#include <linux/pid.h>         // find_pid_ns, pid_task
+#include <linux/pid_namespace.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+#include <linux/math64.h>
+#include <linux/ktime.h>
+#include <linux/workqueue.h>
+
+#include "202000173_growth_tracker.h"
+
+/*
+ * Rastreador de crecimiento de memoria por proceso, para detectar fugas.
+ *
+ * Un trabajo periódico de baja frecuencia toma una muestra de RSS y memoria
+ * virtual de cada proceso y la agrega al anillo de su entrada. La pendiente
+ * se calcula solo cuando alguien consulta (syscalls 575 y 576), así que el
+ * costo de cada tick es una pasada por la lista de procesos.
+ *
+ * Cada tick tiene dos fases: bajo RCU se copian los valores a un arreglo
+ * (no se puede reservar memoria ahí) y después, con growth_lock, se
+ * incorporan a la tabla y se eliminan las entradas de procesos que ya no
+ * aparecieron.
+ */
+#define GROWTH_REBASE_MS (U32_MAX / 2)
+
+struct growth_snapshot {
+	pid_t pid;
+	u64 start_time;
+	unsigned long rss_pages;
+	unsigned long vm_pages;
+	char comm[TASK_COMM_LEN];
+};
+
+DEFINE_HASHTABLE(growth_table, GROWTH_HASH_BITS);
+DEFINE_MUTEX(growth_lock);
+static DEFINE_MUTEX(growth_ctl_lock);    /* Serializa arranque, reconfiguración y parada */
+static unsigned int growth_interval_ms;  /* 0: detenido */
+static unsigned int growth_nr_entries;
+static u32 growth_gen;
+
+static struct growth_snapshot *growth_snap;
+static unsigned int growth_snap_size;
+
+static void growth_work_fn(struct work_struct *work);
+static DECLARE_DELAYED_WORK(growth_work, growth_work_fn);
+
+static struct growth_entry *growth_find(pid_t pid)
+{
+	struct growth_entry *entry;
+
+	hash_for_each_possible(growth_table, entry, node, pid) {
+		if (entry->pid == pid)
+			return entry;
+	}
+	return NULL;
+}
+
+/*
+ * Fase 1: copia los valores de cada proceso con mm. Retorna la cantidad de
+ * procesos copiados; si el arreglo se queda corto, los procesos que no
+ * cupieron se cuentan como no vistos y se vuelven a agregar cuando el arreglo
+ * crezca en el siguiente tick.
+ */
+static unsigned int growth_collect(void)
+{
+	struct task_struct *p, *t;
+	struct growth_snapshot *snap;
+	unsigned int n = 0;
+
+	rcu_read_lock();
+	for_each_process(p) {
+		if (p->flags & PF_KTHREAD)
+			continue;
+		if (n == growth_snap_size)
+			break;
+
+		t = find_lock_task_mm(p);
+		if (!t)
+			continue;
+		snap = &growth_snap[n++];
+		snap->pid        = task_tgid_nr(p);
+		snap->start_time = p->start_time;
+		snap->rss_pages  = get_mm_rss(t->mm);
+		snap->vm_pages   = t->mm->total_vm;
+		task_unlock(t);
+		get_task_comm(snap->comm, p);
+	}
+	rcu_read_unlock();
+	return n;
+}
+
+static void growth_push(struct growth_entry *entry, const struct growth_snapshot *snap, u64 now_ms)
+{
+	struct growth_sample *sample;
+
+	// Los tiempos del anillo son u32 relativos a base_ms: se reinicia antes de desbordar
+	if (!entry->count || now_ms - entry->base_ms > GROWTH_REBASE_MS) {
+		entry->base_ms = now_ms;
+		entry->head = 0;
+		entry->count = 0;
+	}
+
+	sample = &entry->ring[entry->head];
+	sample->ms        = now_ms - entry->base_ms;
+	sample->rss_pages = min_t(unsigned long, snap->rss_pages, U32_MAX);
+	sample->vm_pages  = min_t(unsigned long, snap->vm_pages, U32_MAX);
+	entry->head = (entry->head + 1) % GROWTH_HISTORY;
+	if (entry->count < GROWTH_HISTORY)
+		entry->count++;
+	memcpy(entry->comm, snap->comm, sizeof(entry->comm));
+}
+
+static void growth_tick(void)
+{
+	struct growth_snapshot *snap;
+	struct growth_entry *entry;
+	struct hlist_node *tmp;
+	unsigned int n, i, want;
+	u64 now_ms = ktime_get_boottime_ns() / NSEC_PER_MSEC;
+	int bkt;
+
+	// El arreglo se ajusta a la cantidad de procesos con un margen para los que aparezcan
+	want = min(nr_processes() + nr_processes() / 8 + 64, GROWTH_MAX_TRACKED);
+	if (want > growth_snap_size) {
+		snap = kvmalloc_array(want, sizeof(*snap), GFP_KERNEL);
+		if (snap) {
+			kvfree(growth_snap);
+			growth_snap = snap;
+			growth_snap_size = want;
+		}
+	}
+	if (!growth_snap)
+		return;
+
+	n = growth_collect();
+
+	mutex_lock(&growth_lock);
+	growth_gen++;
+	for (i = 0; i < n; i++) {
+		snap = &growth_snap[i];
+		entry = growth_find(snap->pid);
+
+		// PID reutilizado: el historial anterior es de otro proceso
+		if (entry && entry->start_time != snap->start_time)
+			entry->count = 0;
+
+		if (!entry) {
+			if (growth_nr_entries >= GROWTH_MAX_TRACKED)
+				continue;
+			entry = kzalloc(sizeof(*entry), GFP_KERNEL);
+			if (!entry)
+				continue;
+			entry->pid = snap->pid;
+			hash_add(growth_table, &entry->node, entry->pid);
+			growth_nr_entries++;
+		}
+		entry->start_time = snap->start_time;
+		entry->gen = growth_gen;
+		growth_push(entry, snap, now_ms);
+	}
+
+	hash_for_each_safe(growth_table, bkt, tmp, entry, node) {
+		if (entry->gen != growth_gen) {
+			hash_del(&entry->node);
+			kfree(entry);
+			growth_nr_entries--;
+		}
+	}
+	mutex_unlock(&growth_lock);
+}
+
+static void growth_work_fn(struct work_struct *work)
+{
+	unsigned int interval;
+
+	growth_tick();
+
+	interval = READ_ONCE(growth_interval_ms);
+	if (interval)
+		queue_delayed_work(system_unbound_wq, &growth_work, msecs_to_jiffies(interval));
+}
+
+static void growth_clear(void)
+{
+	struct growth_entry *entry;
+	struct hlist_node *tmp;
+	int bkt;
+
+	mutex_lock(&growth_lock);
+	hash_for_each_safe(growth_table, bkt, tmp, entry, node) {
+		hash_del(&entry->node);
+		kfree(entry);
+	}
+	growth_nr_entries = 0;
+	mutex_unlock(&growth_lock);
+
+	kvfree(growth_snap);
+	growth_snap = NULL;
+	growth_snap_size = 0;
+}
+
+/*
+ * Arranca, reconfigura o detiene (interval_ms == 0) el rastreador. Al
+ * detenerlo se descarta todo el historial. Un cambio de intervalo conserva
+ * el historial: las pendientes usan el tiempo de cada muestra.
+ */
+int growth_tracker_set_interval(unsigned int interval_ms)
+{
+	unsigned int old;
+
+	mutex_lock(&growth_ctl_lock);
+	old = growth_interval_ms;
+	WRITE_ONCE(growth_interval_ms, interval_ms);
+
+	if (!interval_ms) {
+		// cancel_delayed_work_sync evita que el trabajo se vuelva a encolar
+		cancel_delayed_work_sync(&growth_work);
+		if (old)
+			growth_clear();
+	} else if (!old) {
+		queue_delayed_work(system_unbound_wq, &growth_work, 0);
+	} else {
+		mod_delayed_work(system_unbound_wq, &growth_work, msecs_to_jiffies(interval_ms));
+	}
+	mutex_unlock(&growth_ctl_lock);
+	return 0;
+}
+
+unsigned int growth_tracker_interval(void)
+{
+	return READ_ONCE(growth_interval_ms);
+}
+
+/*
+ * Entrada del proceso pid, o NULL si no tiene historial o si el PID se
+ * reutilizó desde la última muestra. Requiere growth_lock.
+ */
+struct growth_entry *growth_lookup(pid_t pid, u64 start_time)
+{
+	struct growth_entry *entry = growth_find(pid);
+
+	if (!entry || entry->start_time != start_time)
+		return NULL;
+	return entry;
+}
+
+/*
+ * PID de la entrada en el espacio de nombres del llamador, o 0 si el proceso
+ * ya terminó, el PID se reutilizó o no es visible desde ese espacio.
+ */
+pid_t growth_entry_vpid(const struct growth_entry *entry)
+{
+	struct task_struct *task;
+	pid_t vpid = 0;
+
+	rcu_read_lock();
+	task = pid_task(find_pid_ns(entry->pid, &init_pid_ns), PIDTYPE_TGID);
+	if (task && task->start_time == entry->start_time)
+		vpid = task_tgid_vnr(task);
+	rcu_read_unlock();
+	return vpid;
+}
+
+/*
+ * Pendiente por mínimos cuadrados de y respecto a x (ms), en bytes por
+ * segundo. y se centra en la primera muestra para que los productos no
+ * desborden con procesos grandes.
+ */
+static s64 growth_slope(const s64 *x, const s64 *y, unsigned int n)
+{
+	s64 sx = 0, sy = 0, sxx = 0, sxy = 0, num, den;
+	unsigned int i;
+	u64 mag;
+
+	for (i = 0; i < n; i++) {
+		sx  += x[i];
+		sy  += y[i] - y[0];
+		sxx += x[i] * x[i];
+		sxy += x[i] * (y[i] - y[0]);
+	}
+	num = n * sxy - sx * sy;
+	den = n * sxx - sx * sx;
+	if (den <= 0)
+		return 0;
+
+	mag = mul_u64_u64_div_u64(abs(num), (u64)PAGE_SIZE * MSEC_PER_SEC, den);
+	return num < 0 ? -(s64)mag : (s64)mag;
+}
+
+/*
+ * Calcula las pendientes y demás campos de info a partir del anillo. info->pid
+ * queda en 0: el llamador lo traduce con growth_entry_vpid().
+ * Retorna false si la entrada aún no tiene GROWTH_MIN_SAMPLES muestras.
+ * Requiere growth_lock.
+ */
+bool growth_fill_info(struct growth_entry *entry, struct growth_info *info)
+{
+	s64 x[GROWTH_HISTORY], rss[GROWTH_HISTORY], vm[GROWTH_HISTORY];
+	const struct growth_sample *sample;
+	unsigned int i, n = entry->count, first;
+
+	if (n < GROWTH_MIN_SAMPLES)
+		return false;
+
+	// Las muestras se ordenan de la más vieja a la más nueva
+	first = (entry->head + GROWTH_HISTORY - n) % GROWTH_HISTORY;
+	memset(info, 0, sizeof(*info));
+	for (i = 0; i < n; i++) {
+		sample = &entry->ring[(first + i) % GROWTH_HISTORY];
+		x[i]   = sample->ms;
+		rss[i] = sample->rss_pages;
+		vm[i]  = sample->vm_pages;
+		// Racha final: cualquier muestra que no crece la reinicia
+		if (i && rss[i] > rss[i - 1])
+			info->rss_increases++;
+		else
+			info->rss_increases = 0;
+	}
+	for (i = n; i-- > 0;)
+		x[i] -= x[0];
+
+	info->samples   = n;
+	memcpy(info->comm, entry->comm, sizeof(info->comm));
+	info->rss_bytes = rss[n - 1] * PAGE_SIZE;
+	info->vm_bytes  = vm[n - 1] * PAGE_SIZE;
+	info->rss_slope = growth_slope(x, rss, n);
+	info->vm_slope  = growth_slope(x, vm, n);
+	info->rss_delta = (rss[n - 1] - rss[0]) * (s64)PAGE_SIZE;
+	info->vm_delta  = (vm[n - 1] - vm[0]) * (s64)PAGE_SIZE;
+	info->window_ms = x[n - 1];
+	return true;
+}
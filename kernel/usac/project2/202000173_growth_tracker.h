@@ -0,0 +1,84 @@
+#ifndef _USAC_202000173_GROWTH_TRACKER_H
+#define _USAC_202000173_GROWTH_TRACKER_H
+
+#include <linux/types.h>
+#include <linux/hashtable.h>
+#include <linux/mutex.h>
+
+/* Límites de la configuración (syscall 574) */
+#define GROWTH_MIN_INTERVAL_MS  1000
+#define GROWTH_MAX_INTERVAL_MS  600000
+#define GROWTH_HISTORY          16      /* Muestras por proceso en el anillo */
+#define GROWTH_MIN_SAMPLES      3       /* Muestras necesarias para calcular una pendiente */
+#define GROWTH_MAX_TRACKED      65536
+#define GROWTH_HASH_BITS        12
+
+/* Criterio de orden de la syscall 575 */
+#define GROWTH_SORT_RSS         0
+#define GROWTH_SORT_VM          1
+
+/*
+ * Estructura que se copia al espacio de usuario (syscall 575).
+ *   - pid: en el espacio de nombres de PID del llamador.
+ *   - rss_slope / vm_slope: pendiente por mínimos cuadrados sobre el anillo,
+ *     en bytes por segundo (negativa si el proceso se reduce).
+ *   - rss_delta / vm_delta: diferencia entre la primera y la última muestra, en bytes.
+ *   - rss_increases: cuántas de las últimas muestras crecieron de forma
+ *     consecutiva respecto a la anterior (0 si la última no creció); una fuga
+ *     crece de forma sostenida, un pico aislado no.
+ */
+struct growth_info {
+	__s32 pid;
+	__u32 samples;
+	char  comm[16];
+	__u64 rss_bytes;
+	__u64 vm_bytes;
+	__s64 rss_slope;
+	__s64 vm_slope;
+	__s64 rss_delta;
+	__s64 vm_delta;
+	__u64 window_ms;
+	__u32 rss_increases;
+	__u32 reserved;
+};
+
+/*
+ * Muestra compacta: 12 bytes. Las páginas caben en 32 bits hasta 16 TB con
+ * páginas de 4 KB, y el tiempo es relativo a base_ms de la entrada.
+ */
+struct growth_sample {
+	u32 ms;
+	u32 rss_pages;
+	u32 vm_pages;
+};
+
+/*
+ * Historial de un proceso. pid es el tgid en init_pid_ns (el trabajo
+ * periódico no tiene espacio de nombres propio); las syscalls lo traducen al
+ * del llamador con growth_entry_vpid(). start_time distingue un PID
+ * reutilizado del proceso original; gen marca el último tick en que se vio
+ * el proceso.
+ */
+struct growth_entry {
+	pid_t pid;
+	u32 gen;
+	u64 start_time;
+	u64 base_ms;
+	char comm[16];
+	u8 head;       /* Próxima posición a escribir */
+	u8 count;
+	struct growth_sample ring[GROWTH_HISTORY];
+	struct hlist_node node;
+};
+
+// Tabla de procesos rastreados; growth_lock la protege junto con sus anillos
+extern DECLARE_HASHTABLE(growth_table, GROWTH_HASH_BITS);
+extern struct mutex growth_lock;
+
+int growth_tracker_set_interval(unsigned int interval_ms);
+unsigned int growth_tracker_interval(void);
+struct growth_entry *growth_lookup(pid_t pid, u64 start_time);
+pid_t growth_entry_vpid(const struct growth_entry *entry);
+bool growth_fill_info(struct growth_entry *entry, struct growth_info *info);
+
+#endif /* _USAC_202000173_GROWTH_TRACKER_H */
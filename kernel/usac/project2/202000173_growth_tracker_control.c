@@ -0,0 +1,30 @@
+#include <linux/kernel.h>
+#include <linux/syscalls.h>   // Para SYSCALL_DEFINE, definir nuevas syscalls
+#include <linux/capability.h> // capable, CAP_SYS_ADMIN
+
+#include "202000173_growth_tracker.h"
+
+/*
+ * Syscall: _202000173_growth_tracker
+ *
+ * Arranca, reconfigura o detiene el rastreador de crecimiento de memoria.
+ * Mientras está activo, cada interval_ms se agrega una muestra de RSS y
+ * memoria virtual al historial de cada proceso.
+ * Argumentos:
+ *   - interval_ms: periodo de muestreo, o 0 para detener y descartar el historial.
+ *
+ * Retorno:
+ *   - 0 si tiene éxito.
+ *   - -EPERM sin CAP_SYS_ADMIN (el costo de cada tick es global).
+ *   - -EINVAL si el intervalo está fuera de rango.
+ */
+SYSCALL_DEFINE1(_202000173_growth_tracker, unsigned int, interval_ms)
+{
+	if (!capable(CAP_SYS_ADMIN))
+		return -EPERM;
+
+	if (interval_ms && (interval_ms < GROWTH_MIN_INTERVAL_MS || interval_ms > GROWTH_MAX_INTERVAL_MS))
+		return -EINVAL;
+
+	return growth_tracker_set_interval(interval_ms);
+}
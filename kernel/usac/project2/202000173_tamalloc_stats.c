@@ -4,6 +4,7 @@
 #include <linux/mman.h>       // vm_mmap, PROT_READ, PROT_WRITE, MAP_PRIVATE
 #include <linux/errno.h>      // Manejo de códigos de error como -EINVAL, -ENOMEM
 #include <linux/sched.h>      // Información de tareas/procesos
+#include <linux/usac_memory_limit.h> // usac_memlimit_charge, límites del proyecto 3
 
 /*
  * Syscall: _202000173_tamalloc_stats
@@ -18,7 +19,8 @@
  * Retorno:
  *   - Dirección base del mapeo (unsigned long) si tiene éxito.
  *   - -EINVAL si el tamaño solicitado es 0.
- *   - -ENOMEM si no se puede asignar memoria (por ejemplo, si el tamaño está mal alineado o no hay suficiente memoria).
+ *   - -ENOMEM si no se puede asignar memoria (por ejemplo, si el tamaño está mal alineado o no hay suficiente memoria)
+ *     o si el proceso excede su límite registrado con la syscall 557.
  */
 SYSCALL_DEFINE1(_202000173_tamalloc_stats, size_t, size)
 {
@@ -45,6 +47,13 @@ SYSCALL_DEFINE1(_202000173_tamalloc_stats, size_t, size)
 	if (!aligned_size)
 		return -ENOMEM;
 
+	/*
+	 * Verificamos el límite de memoria del proceso (o de su grupo) antes de
+	 * crear el mapeo.
+	 */
+	if (usac_memlimit_charge(aligned_size, USAC_MEMLIMIT_SITE_TAMALLOC))
+		return -ENOMEM;
+
 	/*
 	 * Solicitamos la asignación de memoria utilizando vm_mmap. Este método crea
 	 * un mapeo anónimo en el espacio de direcciones del proceso llamante.
@@ -0,0 +1,420 @@
+#include <linux/kernel.h>
+#include <linux/mm.h>
+#include <linux/mmu_notifier.h>
+#include <linux/pagewalk.h>
+#include <linux/page_idle.h>
+#include <linux/huge_mm.h>
+#include <linux/sched.h>
+#include <linux/sched/mm.h>
+#include <linux/sched/task.h>
+#include <linux/pid.h>
+#include <linux/slab.h>
+#include <linux/random.h>
+#include <linux/sort.h>
+#include <linux/math64.h>
+#include <linux/ktime.h>
+
+#include "202000173_working_set.h"
+
+/*
+ * Estimador del working set por proceso.
+ *
+ * En lugar de recorrer todo el espacio de direcciones, cada proceso tiene un
+ * conjunto fijo de páginas muestreadas. En cada escaneo se limpia el bit de
+ * acceso (young) de la PTE de cada muestra y se recuerda cuántos escaneos
+ * seguidos lleva sin acceso. Las muestras que dejan de estar residentes se
+ * vuelven a sortear al azar entre las VMAs del proceso; una muestra nueva que
+ * cae en una página no residente se vuelve a sortear en el mismo escaneo,
+ * hasta WORKING_SET_RESAMPLE_TRIES veces.
+ *
+ * Al limpiar un bit young se marca la página con folio_set_young() (igual que
+ * DAMON e idle page tracking), para que el reclaim la siga viendo como usada.
+ */
+#define WORKING_SET_AGE_UNPRIMED 0xff  /* Muestra nueva: el primer escaneo solo limpia el bit */
+#define WORKING_SET_AGE_MAX      0xfe
+#define WORKING_SET_BATCH        256   /* Muestras entre revisiones de contención de mmap_lock */
+#define WORKING_SET_RESAMPLE_TRIES 4   /* Sorteos por escaneo para las ranuras libres */
+
+LIST_HEAD(working_set_entries);
+DEFINE_MUTEX(working_set_lock);
+static unsigned int working_set_nr_entries;
+
+struct working_set_entry *working_set_find(pid_t pid)
+{
+	struct working_set_entry *entry;
+
+	list_for_each_entry(entry, &working_set_entries, list) {
+		if (entry->pid == pid)
+			return entry;
+	}
+	return NULL;
+}
+
+/*
+ * pmd_entry para una sola página: limpia el bit young de la PTE (o del PMD si
+ * es un THP) y deja en walk->private 1 si estaba encendido, 0 si no.
+ * Si la página no está presente walk->private queda en -1.
+ */
+static int working_set_pmd_entry(pmd_t *pmd, unsigned long addr, unsigned long next,
+				 struct mm_walk *walk)
+{
+	int *young = walk->private;
+	struct page *page;
+	spinlock_t *ptl;
+	pte_t *pte;
+	pte_t ptent;
+
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	if (pmd_trans_huge(READ_ONCE(*pmd))) {
+		ptl = pmd_lock(walk->mm, pmd);
+		if (pmd_present(*pmd) && pmd_trans_huge(*pmd)) {
+			*young = pmdp_clear_young_notify(walk->vma, addr, pmd);
+			if (*young)
+				folio_set_young(page_folio(pmd_page(*pmd)));
+			spin_unlock(ptl);
+			return 0;
+		}
+		spin_unlock(ptl);
+	}
+#endif
+
+	pte = pte_offset_map_lock(walk->mm, pmd, addr, &ptl);
+	if (!pte) {
+		walk->action = ACTION_AGAIN;
+		return 0;
+	}
+
+	ptent = ptep_get(pte);
+	if (pte_present(ptent)) {
+		*young = ptep_clear_young_notify(walk->vma, addr, pte);
+		page = vm_normal_page(walk->vma, addr, ptent);
+		if (*young && page)
+			folio_set_young(page_folio(page));
+	}
+	pte_unmap_unlock(pte, ptl);
+	return 0;
+}
+
+static const struct mm_walk_ops working_set_walk_ops = {
+	.pmd_entry = working_set_pmd_entry,
+	.walk_lock = PGWALK_RDLOCK,
+};
+
+/* VMAs que se pueden muestrear: se excluyen mapeos de I/O, PFN y hugetlbfs */
+static bool working_set_vma_ok(struct vm_area_struct *vma)
+{
+	return !(vma->vm_flags & (VM_SPECIAL | VM_HUGETLB));
+}
+
+static int working_set_cmp_u64(const void *a, const void *b)
+{
+	u64 x = *(const u64 *)a, y = *(const u64 *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/*
+ * Sortea una dirección nueva para cada una de las needed ranuras libres,
+ * uniforme sobre las páginas de las VMAs muestreables. Los desplazamientos se
+ * ordenan para asignarlos todos en una sola pasada por las VMAs. Retorna
+ * false si no hay nada que muestrear. Requiere mmap_lock.
+ */
+static bool working_set_draw(struct working_set_entry *entry, struct mm_struct *mm,
+			     unsigned int needed)
+{
+	struct vm_area_struct *vma;
+	unsigned int i, j, k;
+	u64 total = 0, base = 0, rem;
+	u64 *offsets;
+
+	{
+		VMA_ITERATOR(vmi, mm, 0);
+
+		for_each_vma(vmi, vma) {
+			if (working_set_vma_ok(vma))
+				total += vma_pages(vma);
+		}
+	}
+	if (!total)
+		return false;
+
+	offsets = kvmalloc_array(needed, sizeof(*offsets), GFP_KERNEL);
+	if (!offsets)
+		return false;
+	for (i = 0; i < needed; i++) {
+		div64_u64_rem(get_random_u64(), total, &rem);
+		offsets[i] = rem;
+	}
+	sort(offsets, needed, sizeof(*offsets), working_set_cmp_u64, NULL);
+
+	{
+		VMA_ITERATOR(vmi, mm, 0);
+
+		j = 0;
+		k = 0;
+		for_each_vma(vmi, vma) {
+			if (!working_set_vma_ok(vma))
+				continue;
+			while (j < needed && offsets[j] < base + vma_pages(vma)) {
+				while (entry->slots[k].addr)
+					k++;
+				entry->slots[k].addr = vma->vm_start + ((offsets[j] - base) << PAGE_SHIFT);
+				entry->slots[k].age = WORKING_SET_AGE_UNPRIMED;
+				j++;
+			}
+			base += vma_pages(vma);
+		}
+	}
+	kvfree(offsets);
+	return true;
+}
+
+/*
+ * Llena las ranuras libres. Las muestras nuevas que caen en páginas no
+ * residentes (VMAs reservadas pero poco tocadas) se vuelven a sortear en vez
+ * de perder la ranura hasta el próximo escaneo. Revisar una muestra nueva ya
+ * limpia su bit young, que es lo mismo que hace su primer escaneo, así que
+ * sigue como WORKING_SET_AGE_UNPRIMED. Requiere mmap_lock.
+ */
+static void working_set_resample(struct working_set_entry *entry, struct mm_struct *mm)
+{
+	struct working_set_slot *slot;
+	unsigned int needed = 0, try, i;
+	int young;
+
+	for (i = 0; i < entry->config.sample_pages; i++) {
+		if (!entry->slots[i].addr)
+			needed++;
+	}
+
+	for (try = 0; needed && try < WORKING_SET_RESAMPLE_TRIES; try++) {
+		if (!working_set_draw(entry, mm, needed))
+			return;
+
+		needed = 0;
+		for (i = 0; i < entry->config.sample_pages; i++) {
+			slot = &entry->slots[i];
+			if (!slot->addr || slot->age != WORKING_SET_AGE_UNPRIMED)
+				continue;
+			young = -1;
+			walk_page_range(mm, slot->addr, slot->addr + PAGE_SIZE,
+					&working_set_walk_ops, &young);
+			if (young < 0) {
+				slot->addr = 0;
+				needed++;
+			}
+		}
+	}
+}
+
+static void working_set_scan(struct working_set_entry *entry)
+{
+	struct working_set_slot *slot;
+	struct task_struct *task;
+	struct mm_struct *mm;
+	u64 hot = 0, warm = 0, cold = 0, sampled = 0, start;
+	unsigned int i;
+	int young;
+
+	task = get_pid_task(entry->pid_ref, PIDTYPE_PID);
+	if (!task) {
+		entry->exited = true;
+		return;
+	}
+	mm = get_task_mm(task);
+	put_task_struct(task);
+	if (!mm) {
+		entry->exited = true;
+		return;
+	}
+
+	start = ktime_get_ns();
+	mutex_lock(&entry->lock);
+
+	// Después de un exec las muestras anteriores ya no significan nada
+	if (mm != entry->mm_cookie) {
+		for (i = 0; i < entry->config.sample_pages; i++)
+			entry->slots[i].addr = 0;
+		entry->mm_cookie = mm;
+	}
+
+	mmap_read_lock(mm);
+	working_set_resample(entry, mm);
+
+	for (i = 0; i < entry->config.sample_pages; i++) {
+		slot = &entry->slots[i];
+
+		/*
+		 * Cada WORKING_SET_BATCH muestras se suelta mmap_lock si alguien
+		 * lo espera (por ejemplo un mmap o un fallo de página del proceso).
+		 */
+		if (i && !(i % WORKING_SET_BATCH) && (mmap_lock_is_contended(mm) || need_resched())) {
+			mmap_read_unlock(mm);
+			cond_resched();
+			mmap_read_lock(mm);
+		}
+
+		if (!slot->addr)
+			continue;
+
+		young = -1;
+		walk_page_range(mm, slot->addr, slot->addr + PAGE_SIZE, &working_set_walk_ops, &young);
+		if (young < 0) {
+			// Ya no está residente (o se desmapeó): se sortea otra en el próximo escaneo
+			slot->addr = 0;
+			continue;
+		}
+
+		if (slot->age == WORKING_SET_AGE_UNPRIMED) {
+			slot->age = 0;
+			continue;
+		}
+
+		slot->age = young ? 0 : min_t(unsigned int, slot->age + 1, WORKING_SET_AGE_MAX);
+		sampled++;
+		if (!slot->age)
+			hot++;
+		else if (slot->age < entry->config.cold_scans)
+			warm++;
+		else
+			cold++;
+	}
+
+	entry->rss_pages = get_mm_rss(mm);
+	mmap_read_unlock(mm);
+	mmput(mm);
+
+	entry->sampled = sampled;
+	entry->hot = hot;
+	entry->warm = warm;
+	entry->cold = cold;
+	entry->scans++;
+	entry->last_scan_ns = ktime_get_ns() - start;
+	entry->total_scan_ns += entry->last_scan_ns;
+	mutex_unlock(&entry->lock);
+}
+
+static void working_set_work_fn(struct work_struct *work)
+{
+	struct working_set_entry *entry = container_of(to_delayed_work(work),
+						       struct working_set_entry, work);
+
+	working_set_scan(entry);
+	if (!entry->exited)
+		queue_delayed_work(system_unbound_wq, &entry->work,
+				   msecs_to_jiffies(entry->config.interval_ms));
+}
+
+static void working_set_free(struct working_set_entry *entry)
+{
+	cancel_delayed_work_sync(&entry->work);
+	put_pid(entry->pid_ref);
+	kvfree(entry->slots);
+	kfree(entry);
+}
+
+/*
+ * Empieza a monitorear task con la configuración dada. Si el proceso ya
+ * estaba monitoreado se reemplaza su configuración y se descartan sus
+ * muestras. Con la tabla llena se libera una entrada de un proceso que ya
+ * terminó, si existe.
+ */
+int working_set_start(struct task_struct *task, const struct working_set_config *config)
+{
+	struct working_set_entry *entry, *old, *victim = NULL;
+
+	entry = kzalloc(sizeof(*entry), GFP_KERNEL);
+	if (!entry)
+		return -ENOMEM;
+	entry->slots = kvcalloc(config->sample_pages, sizeof(*entry->slots), GFP_KERNEL);
+	if (!entry->slots) {
+		kfree(entry);
+		return -ENOMEM;
+	}
+
+	entry->pid = task_pid_vnr(task);
+	entry->pid_ref = get_task_pid(task, PIDTYPE_PID);
+	entry->config = *config;
+	mutex_init(&entry->lock);
+	INIT_DELAYED_WORK(&entry->work, working_set_work_fn);
+
+	mutex_lock(&working_set_lock);
+	old = working_set_find(entry->pid);
+	if (old) {
+		list_del(&old->list);
+		working_set_nr_entries--;
+	} else if (working_set_nr_entries >= WORKING_SET_MAX_MONITORED) {
+		list_for_each_entry(victim, &working_set_entries, list) {
+			if (READ_ONCE(victim->exited))
+				break;
+		}
+		if (list_entry_is_head(victim, &working_set_entries, list)) {
+			mutex_unlock(&working_set_lock);
+			put_pid(entry->pid_ref);
+			kvfree(entry->slots);
+			kfree(entry);
+			return -ENOSPC;
+		}
+		list_del(&victim->list);
+		working_set_nr_entries--;
+	}
+	list_add_tail(&entry->list, &working_set_entries);
+	working_set_nr_entries++;
+	mutex_unlock(&working_set_lock);
+
+	// Se liberan fuera del lock porque cancel_delayed_work_sync puede esperar un escaneo
+	if (old)
+		working_set_free(old);
+	if (victim)
+		working_set_free(victim);
+
+	queue_delayed_work(system_unbound_wq, &entry->work, 0);
+	return 0;
+}
+
+int working_set_stop(pid_t pid)
+{
+	struct working_set_entry *entry;
+
+	mutex_lock(&working_set_lock);
+	entry = working_set_find(pid);
+	if (entry) {
+		list_del(&entry->list);
+		working_set_nr_entries--;
+	}
+	mutex_unlock(&working_set_lock);
+
+	if (!entry)
+		return -ESRCH;
+	working_set_free(entry);
+	return 0;
+}
+
+/* Copia los resultados del último escaneo. Requiere working_set_lock. */
+void working_set_fill_info(struct working_set_entry *entry, struct working_set_info *info)
+{
+	u64 scale;
+
+	memset(info, 0, sizeof(*info));
+	mutex_lock(&entry->lock);
+	info->pid           = entry->pid;
+	info->exited        = entry->exited;
+	info->config        = entry->config;
+	info->scans         = entry->scans;
+	info->rss_pages     = entry->rss_pages;
+	info->sampled       = entry->sampled;
+	info->hot_samples   = entry->hot;
+	info->warm_samples  = entry->warm;
+	info->cold_samples  = entry->cold;
+	info->last_scan_ns  = entry->last_scan_ns;
+	info->total_scan_ns = entry->total_scan_ns;
+	mutex_unlock(&entry->lock);
+
+	// Cada muestra representa rss / sampled páginas residentes
+	if (info->sampled) {
+		scale = info->rss_pages * PAGE_SIZE;
+		info->hot_bytes  = div64_u64(info->hot_samples * scale, info->sampled);
+		info->warm_bytes = div64_u64(info->warm_samples * scale, info->sampled);
+		info->cold_bytes = div64_u64(info->cold_samples * scale, info->sampled);
+	}
+}
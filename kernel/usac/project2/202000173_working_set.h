@@ -0,0 +1,90 @@
+#ifndef _USAC_202000173_WORKING_SET_H
+#define _USAC_202000173_WORKING_SET_H
+
+#include <linux/types.h>
+#include <linux/list.h>
+#include <linux/mutex.h>
+#include <linux/workqueue.h>
+
+struct pid;
+struct mm_struct;
+struct task_struct;
+
+/* Límites de la configuración (syscall 569) */
+#define WORKING_SET_MIN_INTERVAL_MS  100
+#define WORKING_SET_MAX_SAMPLE_PAGES 16384
+#define WORKING_SET_MAX_MONITORED    64
+
+/*
+ * Configuración del muestreo. El costo de cada escaneo es proporcional a
+ * sample_pages, sin importar el tamaño del proceso.
+ *   - interval_ms: periodo entre escaneos; también es la ventana "hot".
+ *   - sample_pages: cantidad de páginas muestreadas.
+ *   - cold_scans: una página sin acceso durante cold_scans escaneos es "cold";
+ *     entre 1 y cold_scans - 1 escaneos es "warm".
+ */
+struct working_set_config {
+	__u32 interval_ms;
+	__u32 sample_pages;
+	__u32 cold_scans;
+	__u32 reserved;
+};
+
+/* Estructura que se copia al espacio de usuario (syscall 570) */
+struct working_set_info {
+	__s32 pid;
+	__u32 exited;          /* 1 si el proceso terminó; los valores son del último escaneo */
+	struct working_set_config config;
+	__u64 scans;
+	__u64 rss_pages;
+	__u64 sampled;         /* Muestras residentes con al menos dos escaneos */
+	__u64 hot_samples;     /* Accedidas en el último intervalo */
+	__u64 warm_samples;
+	__u64 cold_samples;
+	__u64 hot_bytes;       /* Estimados: muestras * RSS / sampled */
+	__u64 warm_bytes;
+	__u64 cold_bytes;
+	__u64 last_scan_ns;    /* Costo del último escaneo */
+	__u64 total_scan_ns;
+};
+
+/* Página muestreada. addr == 0 indica una ranura libre que se vuelve a sortear. */
+struct working_set_slot {
+	unsigned long addr;
+	u8 age;                /* Escaneos consecutivos sin acceso */
+};
+
+/*
+ * Proceso monitoreado. El trabajo periódico es el único que escribe slots y
+ * los resultados; lock los protege de las lecturas de la syscall 570.
+ */
+struct working_set_entry {
+	pid_t pid;
+	struct pid *pid_ref;
+	struct working_set_config config;
+	struct mm_struct *mm_cookie;   /* Solo para detectar exec; nunca se desreferencia */
+	struct working_set_slot *slots;
+	struct mutex lock;
+	bool exited;
+	u64 scans;
+	u64 rss_pages;
+	u64 sampled;
+	u64 hot;
+	u64 warm;
+	u64 cold;
+	u64 last_scan_ns;
+	u64 total_scan_ns;
+	struct delayed_work work;
+	struct list_head list;         /* working_set_entries */
+};
+
+// Lista de procesos monitoreados y mutex que protege sus altas y bajas
+extern struct list_head working_set_entries;
+extern struct mutex working_set_lock;
+
+struct working_set_entry *working_set_find(pid_t pid);
+int working_set_start(struct task_struct *task, const struct working_set_config *config);
+int working_set_stop(pid_t pid);
+void working_set_fill_info(struct working_set_entry *entry, struct working_set_info *info);
+
+#endif /* _USAC_202000173_WORKING_SET_H */
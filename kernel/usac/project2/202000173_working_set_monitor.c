@@ -0,0 +1,61 @@
+#include <linux/kernel.h>
+#include <linux/syscalls.h>   // Para SYSCALL_DEFINE, definir nuevas syscalls
+#include <linux/uaccess.h>    // copy_from_user
+#include <linux/capability.h> // capable, CAP_SYS_ADMIN
+#include <linux/pid.h>        // find_vpid, get_pid_task
+#include <linux/sched.h>
+#include <linux/sched/task.h> // put_task_struct
+
+#include "202000173_working_set.h"
+
+/*
+ * Syscall: _202000173_working_set_monitor
+ *
+ * Empieza, reconfigura o detiene la estimación del working set de un proceso.
+ * Argumentos:
+ *   - pid: Proceso a monitorear.
+ *   - config: Configuración del muestreo, o NULL para dejar de monitorear.
+ *
+ * Retorno:
+ *   - 0 si tiene éxito.
+ *   - -EPERM sin CAP_SYS_ADMIN (el escaneo modifica los bits de acceso del proceso).
+ *   - -EINVAL si la configuración está fuera de rango.
+ *   - -ESRCH si el proceso no existe (o no estaba monitoreado, con config NULL).
+ *   - -ENOSPC si ya hay WORKING_SET_MAX_MONITORED procesos monitoreados.
+ */
+SYSCALL_DEFINE2(_202000173_working_set_monitor, pid_t, pid,
+		const struct working_set_config __user *, user_config)
+{
+	struct working_set_config config;
+	struct task_struct *task;
+	int ret;
+
+	if (!capable(CAP_SYS_ADMIN))
+		return -EPERM;
+
+	if (pid <= 0)
+		return -EINVAL;
+
+	if (!user_config)
+		return working_set_stop(pid);
+
+	if (copy_from_user(&config, user_config, sizeof(config)))
+		return -EFAULT;
+
+	/*
+	 * cold_scans cuenta escaneos sin acceso en un u8, y con menos de 2 no
+	 * habría páginas "warm".
+	 */
+	if (config.interval_ms < WORKING_SET_MIN_INTERVAL_MS ||
+	    config.sample_pages == 0 || config.sample_pages > WORKING_SET_MAX_SAMPLE_PAGES ||
+	    config.cold_scans < 2 || config.cold_scans > 254 || config.reserved)
+		return -EINVAL;
+
+	task = get_pid_task(find_vpid(pid), PIDTYPE_PID);
+	if (!task)
+		return -ESRCH;
+
+	ret = working_set_start(task, &config);
+	put_task_struct(task);
+	return ret;
+}
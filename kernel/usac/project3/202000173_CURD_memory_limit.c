@@ -0,0 +1,790 @@
+#include <linux/kernel.h>
+#include <linux/init.h>
+#include <linux/slab.h>
+#include <linux/errno.h>
+#include <linux/sched.h>
+#include <linux/sched/signal.h>
+#include <linux/mm.h>
+#include <linux/list.h>
+#include <linux/hashtable.h>
+#include <linux/cred.h>
+#include <linux/rculist.h>
+#include <linux/mman.h>
+#include <linux/pagewalk.h>
+#include <linux/mmu_notifier.h>
+#include <linux/page_idle.h>
+#include <linux/ktime.h>
+#include <linux/jiffies.h>
+#include <linux/math64.h>
+#include <trace/events/sched.h>
+
+#include "202000173_memory_limit.h"
+
+/*
+ * Núcleo del registro de límites de memoria compartido por las syscalls
+ * 557-566. Todas las modificaciones se hacen con memory_limit_lock tomado;
+ * las búsquedas desde los caminos de reserva solo usan RCU.
+ */
+
+// Lista global para almacenar los procesos limitados
+LIST_HEAD(memory_limited_processes);
+// Lista global de usuarios limitados (pocos elementos, se recorre con RCU)
+LIST_HEAD(memory_limited_users);
+DEFINE_SPINLOCK(memory_limit_lock);
+unsigned int memory_limit_nr_owners;
+unsigned int memory_limit_nr_entries;
+unsigned int memory_limit_nr_users;
+
+// Tabla hash pid -> entrada, incluye owners y miembros heredados
+static DEFINE_HASHTABLE(memory_limit_hash, 10);
+// Tabla hash pid -> proceso que aporta al límite de su usuario
+static DEFINE_HASHTABLE(memory_limit_uid_hash, 10);
+
+long memory_limit_task_usage(struct task_struct *task)
+{
+    long usage = 0;
+
+    if (!task)
+        return 0;
+
+    /* task_lock evita que exit_mm() libere el mm mientras lo leemos */
+    task_lock(task);
+    if (task->mm) {
+        /* total_vm está en "páginas"; lo convertimos a bytes con PAGE_SHIFT. */
+        usage = (long)(READ_ONCE(task->mm->total_vm) << PAGE_SHIFT);
+    }
+    task_unlock(task);
+
+    return usage;
+}
+
+/* Requiere rcu_read_lock() o memory_limit_lock */
+struct memory_limitation_entry *memory_limit_find(pid_t pid)
+{
+    struct memory_limitation_entry *entry;
+
+    hash_for_each_possible_rcu(memory_limit_hash, entry, hnode, pid,
+                               lockdep_is_held(&memory_limit_lock)) {
+        if (entry->pid == pid)
+            return entry;
+    }
+    return NULL;
+}
+
+/* Requiere memory_limit_lock. El aporte inicial de la entrada ya está en charged. */
+void memory_limit_add_entry(struct memory_limitation_entry *entry)
+{
+    atomic_long_add(atomic_long_read(&entry->charged), &entry->group->usage);
+    hash_add_rcu(memory_limit_hash, &entry->hnode, entry->pid);
+    memory_limit_nr_entries++;
+
+    if (entry->owner) {
+        list_add(&entry->list, &memory_limited_processes);
+        memory_limit_nr_owners++;
+    }
+}
+
+/*
+ * Requiere memory_limit_lock. Elimina al owner y a todos los procesos que
+ * heredaron su grupo; la memoria se libera cuando terminan los lectores RCU.
+ */
+void memory_limit_remove_group(struct memory_limitation_entry *owner)
+{
+    struct memory_limit_group *group = owner->group;
+    struct memory_limitation_entry *entry;
+    struct hlist_node *tmp;
+    int bkt;
+
+    hash_for_each_safe(memory_limit_hash, bkt, tmp, entry, hnode) {
+        if (entry->group != group)
+            continue;
+        hash_del_rcu(&entry->hnode);
+        memory_limit_nr_entries--;
+        if (entry->owner) {
+            list_del(&entry->list);
+            memory_limit_nr_owners--;
+        }
+        kfree_rcu(entry, rcu);
+    }
+    kfree_rcu(group, rcu);
+}
+
+/* Requiere memory_limit_lock. Llena hasta max_entries registros de estadísticas. */
+size_t memory_limit_collect_stats(struct memory_limitation_stats *buffer, size_t max_entries)
+{
+    struct memory_limitation_entry *entry;
+    size_t count = 0;
+    long usage;
+    int bkt;
+
+    hash_for_each(memory_limit_hash, bkt, entry, hnode) {
+        if (count >= max_entries)
+            break;
+
+        buffer[count].pid          = entry->pid;
+        buffer[count].group_pid    = entry->group->pid;
+        buffer[count].flags        = entry->group->flags;
+        buffer[count].owner        = entry->owner;
+        buffer[count].memory_limit = entry->group->memory_limit;
+        usage = atomic_long_read(&entry->group->usage);
+        buffer[count].group_usage  = usage > 0 ? usage : 0;
+        usage = atomic_long_read(&entry->charged);
+        buffer[count].usage        = usage > 0 ? usage : 0;
+        buffer[count].reclaim_count    = atomic64_read(&entry->reclaim_count);
+        buffer[count].reclaimed_pages  = atomic64_read(&entry->reclaimed_pages);
+        buffer[count].reclaim_stall_ns = atomic64_read(&entry->reclaim_stall_ns);
+        buffer[count].soft_limit       = entry->group->soft_limit;
+        buffer[count].max_delay_ms     = entry->group->max_delay_ms;
+        buffer[count].throttle_count   = atomic64_read(&entry->throttle_count);
+        buffer[count].throttle_ns      = atomic64_read(&entry->throttle_ns);
+        count++;
+    }
+
+    return count;
+}
+
+/* Requiere rcu_read_lock() o memory_limit_lock */
+struct memory_limit_uid_group *memory_limit_find_uid(kuid_t uid)
+{
+    struct memory_limit_uid_group *group;
+
+    list_for_each_entry_rcu(group, &memory_limited_users, list,
+                            lockdep_is_held(&memory_limit_lock)) {
+        if (uid_eq(group->uid, uid))
+            return group;
+    }
+    return NULL;
+}
+
+static struct memory_limit_uid_member *memory_limit_find_uid_member(pid_t pid)
+{
+    struct memory_limit_uid_member *member;
+
+    hash_for_each_possible_rcu(memory_limit_uid_hash, member, hnode, pid,
+                               lockdep_is_held(&memory_limit_lock)) {
+        if (member->pid == pid)
+            return member;
+    }
+    return NULL;
+}
+
+/* Requiere memory_limit_lock */
+static void memory_limit_add_uid_member(struct memory_limit_uid_member *member)
+{
+    atomic_long_add(atomic_long_read(&member->charged), &member->group->usage);
+    atomic_inc(&member->group->nr_members);
+    hash_add_rcu(memory_limit_uid_hash, &member->hnode, member->pid);
+}
+
+/* Requiere memory_limit_lock */
+static void memory_limit_del_uid_member(struct memory_limit_uid_member *member)
+{
+    atomic_long_sub(atomic_long_xchg(&member->charged, 0), &member->group->usage);
+    atomic_dec(&member->group->nr_members);
+    hash_del_rcu(&member->hnode);
+    kfree_rcu(member, rcu);
+}
+
+/*
+ * Reserva, sin locks, un miembro por cada proceso actual de uid más un margen
+ * para los que se creen antes de tomar memory_limit_lock. Retorna 0 o -ENOMEM.
+ */
+int memory_limit_uid_prealloc(struct memory_limit_uid_prealloc *pre, kuid_t uid)
+{
+    struct task_struct *task;
+    unsigned int count = MEMLIMIT_UID_PREALLOC_SLACK;
+
+    rcu_read_lock();
+    for_each_process(task) {
+        if (!(task->flags & PF_KTHREAD) && uid_eq(task_uid(task), uid))
+            count++;
+    }
+    rcu_read_unlock();
+
+    pre->nr = 0;
+    pre->members = kvmalloc_array(count, sizeof(*pre->members), GFP_KERNEL);
+    if (!pre->members)
+        return -ENOMEM;
+
+    while (pre->nr < count) {
+        pre->members[pre->nr] = kzalloc(sizeof(**pre->members), GFP_KERNEL);
+        if (!pre->members[pre->nr]) {
+            memory_limit_uid_prealloc_free(pre);
+            return -ENOMEM;
+        }
+        pre->nr++;
+    }
+    return 0;
+}
+
+/* Libera los miembros que memory_limit_add_uid no usó */
+void memory_limit_uid_prealloc_free(struct memory_limit_uid_prealloc *pre)
+{
+    while (pre->nr)
+        kfree(pre->members[--pre->nr]);
+    kvfree(pre->members);
+    pre->members = NULL;
+}
+
+/*
+ * Requiere memory_limit_lock. Registra el límite del usuario y agrega como
+ * miembros a sus procesos actuales para que usage parta del uso real. Solo
+ * usa los miembros de pre, reservados antes de tomar el spinlock.
+ */
+void memory_limit_add_uid(struct memory_limit_uid_group *group,
+                          struct memory_limit_uid_prealloc *pre)
+{
+    struct memory_limit_uid_member *member;
+    struct task_struct *task;
+
+    list_add_rcu(&group->list, &memory_limited_users);
+    memory_limit_nr_users++;
+
+    rcu_read_lock();
+    for_each_process(task) {
+        if ((task->flags & PF_KTHREAD) || !uid_eq(task_uid(task), group->uid))
+            continue;
+        if (memory_limit_find_uid_member(task->tgid))
+            continue;
+
+        if (!pre->nr)
+            break;  /* El resto se agrega en su primera reserva */
+        member = pre->members[--pre->nr];
+
+        member->pid = task->tgid;
+        member->group = group;
+        atomic_long_set(&member->charged, memory_limit_task_usage(task));
+        memory_limit_add_uid_member(member);
+    }
+    rcu_read_unlock();
+}
+
+/* Requiere memory_limit_lock */
+void memory_limit_remove_uid(struct memory_limit_uid_group *group)
+{
+    struct memory_limit_uid_member *member;
+    struct hlist_node *tmp;
+    int bkt;
+
+    hash_for_each_safe(memory_limit_uid_hash, bkt, tmp, member, hnode) {
+        if (member->group == group)
+            memory_limit_del_uid_member(member);
+    }
+    list_del_rcu(&group->list);
+    memory_limit_nr_users--;
+    kfree_rcu(group, rcu);
+}
+
+/*
+ * Camino lento: el proceso aún no aporta al límite de su usuario, o cambió de
+ * usuario (setuid) desde la última reserva. Solo ocurre una vez por proceso.
+ */
+static void memory_limit_uid_attach(void)
+{
+    struct memory_limit_uid_member *member, *new_member;
+    struct memory_limit_uid_group *group;
+
+    new_member = kzalloc(sizeof(*new_member), GFP_KERNEL);
+
+    spin_lock(&memory_limit_lock);
+    member = memory_limit_find_uid_member(current->tgid);
+    group = memory_limit_find_uid(current_uid());
+    if (member && member->group != group) {
+        memory_limit_del_uid_member(member);
+        member = NULL;
+    }
+    if (!member && group && new_member) {
+        new_member->pid = current->tgid;
+        new_member->group = group;
+        atomic_long_set(&new_member->charged, memory_limit_task_usage(current));
+        memory_limit_add_uid_member(new_member);
+        new_member = NULL;
+    }
+    spin_unlock(&memory_limit_lock);
+
+    kfree(new_member);
+}
+
+/*
+ * Bytes que aporta un mm a su grupo: memoria virtual (total_vm) por defecto, o
+ * memoria residente con MEMLIMIT_RECLAIM, que es la que la recuperación reduce.
+ */
+static long memory_limit_mm_bytes(struct mm_struct *mm, unsigned int flags)
+{
+    if (flags & MEMLIMIT_RECLAIM)
+        return (long)(get_mm_rss(mm) << PAGE_SHIFT);
+
+    return (long)(READ_ONCE(mm->total_vm) << PAGE_SHIFT);
+}
+
+/*
+ * Actualiza el aporte del proceso al grupo con la diferencia desde la última
+ * sincronización. Así el contador refleja tanto reservas como liberaciones
+ * sin tener que engancharse a munmap.
+ */
+static long memory_limit_sync(atomic_long_t *charged, atomic_long_t *usage,
+                              struct mm_struct *mm, unsigned int flags)
+{
+    long now = memory_limit_mm_bytes(mm, flags);
+    long before = atomic_long_xchg(charged, now);
+
+    return atomic_long_add_return(now - before, usage);
+}
+
+/*
+ * MEMLIMIT_RECLAIM. Cada pasada recupera como mucho el exceso sobre 7/8 del
+ * límite y solo páginas frías: el barrido limpia el bit young de las PTEs que
+ * recorre y únicamente envía a swap las que no fueron accedidas desde la
+ * pasada anterior. Continúa donde terminó la pasada anterior (como un reloj),
+ * así las páginas calientes nunca salen por estar al inicio del espacio de
+ * direcciones. Envejecer páginas cuenta como avance: la pasada siguiente ya
+ * puede recuperarlas. Si una pasada proactiva no recupera ni envejece nada la
+ * siguiente se aplaza el doble; al superar el límite duro no hay espera.
+ */
+#define MEMLIMIT_RECLAIM_INTERVAL    (HZ / 10)  /* Mínimo entre recuperaciones proactivas */
+#define MEMLIMIT_RECLAIM_MAX_BACKOFF 6          /* Hasta 64 intervalos sin éxito */
+#define MEMLIMIT_RECLAIM_MIN_SCAN    512        /* PTEs revisadas por pasada como mínimo */
+#define MEMLIMIT_RECLAIM_RUNS        32         /* Rangos fríos por pasada */
+
+struct memory_limit_reclaim_walk {
+    unsigned long target;        /* Páginas frías que se buscan */
+    unsigned long found;
+    unsigned long aged;          /* Páginas con bit young que se limpió */
+    unsigned long scan_budget;   /* PTEs que todavía se pueden revisar */
+    unsigned long next;          /* Dirección donde se detuvo el barrido */
+    unsigned int nr_runs;
+    struct {
+        unsigned long start, end;
+    } runs[MEMLIMIT_RECLAIM_RUNS];
+};
+
+/* Igual que MADV_PAGEOUT: se omiten mapeos bloqueados, de I/O y hugetlbfs */
+static int memory_limit_reclaim_test_walk(unsigned long start, unsigned long end,
+                                          struct mm_walk *walk)
+{
+    return !!(walk->vma->vm_flags & (VM_LOCKED | VM_SPECIAL | VM_HUGETLB));
+}
+
+/*
+ * Agrega addr a los rangos fríos, extendiendo el último si es contiguo.
+ * Retorna false si ya no caben más rangos.
+ */
+static bool memory_limit_reclaim_add(struct memory_limit_reclaim_walk *rw, unsigned long addr)
+{
+    if (rw->nr_runs && rw->runs[rw->nr_runs - 1].end == addr) {
+        rw->runs[rw->nr_runs - 1].end += PAGE_SIZE;
+    } else {
+        if (rw->nr_runs == MEMLIMIT_RECLAIM_RUNS)
+            return false;
+        rw->runs[rw->nr_runs].start = addr;
+        rw->runs[rw->nr_runs].end = addr + PAGE_SIZE;
+        rw->nr_runs++;
+    }
+    rw->found++;
+    return true;
+}
+
+/*
+ * Las páginas con el bit young encendido se envejecen (se limpia el bit y se
+ * marca el folio con folio_set_young() como hace working_set) y se saltan;
+ * las que ya lo tenían apagado se agregan a los rangos fríos. Los THP se
+ * dejan a la recuperación global.
+ */
+static int memory_limit_reclaim_pmd_entry(pmd_t *pmd, unsigned long addr, unsigned long end,
+                                          struct mm_walk *walk)
+{
+    struct memory_limit_reclaim_walk *rw = walk->private;
+    struct page *page;
+    spinlock_t *ptl;
+    pte_t *start_pte, *pte;
+    pte_t ptent;
+    int stop = 0;
+
+    if (pmd_trans_huge(READ_ONCE(*pmd))) {
+        rw->next = end;
+        return 0;
+    }
+
+    start_pte = pte = pte_offset_map_lock(walk->mm, pmd, addr, &ptl);
+    if (!pte) {
+        walk->action = ACTION_AGAIN;
+        return 0;
+    }
+
+    for (; addr < end; pte++, addr += PAGE_SIZE) {
+        if (rw->found >= rw->target || !rw->scan_budget) {
+            stop = 1;
+            break;
+        }
+        rw->scan_budget--;
+
+        ptent = ptep_get(pte);
+        if (!pte_present(ptent))
+            continue;
+        page = vm_normal_page(walk->vma, addr, ptent);
+        if (!page)
+            continue;
+
+        if (ptep_clear_young_notify(walk->vma, addr, pte)) {
+            folio_set_young(page_folio(page));
+            rw->aged++;
+            continue;
+        }
+        if (!memory_limit_reclaim_add(rw, addr)) {
+            stop = 1;
+            break;
+        }
+    }
+    pte_unmap_unlock(start_pte, ptl);
+
+    rw->next = addr;
+    return stop;
+}
+
+static const struct mm_walk_ops memory_limit_reclaim_walk_ops = {
+    .pmd_entry = memory_limit_reclaim_pmd_entry,
+    .test_walk = memory_limit_reclaim_test_walk,
+    .walk_lock = PGWALK_RDLOCK,
+};
+
+/*
+ * Busca hasta rw->target páginas frías desde cursor, dando a lo más una vuelta
+ * al espacio de direcciones. Retorna la dirección donde debe seguir la próxima
+ * pasada.
+ */
+static unsigned long memory_limit_reclaim_scan(struct mm_struct *mm,
+                                               struct memory_limit_reclaim_walk *rw,
+                                               unsigned long cursor)
+{
+    int ret;
+
+    if (cursor >= TASK_SIZE)
+        cursor = 0;
+
+    if (mmap_read_lock_killable(mm))
+        return cursor;
+
+    ret = walk_page_range(mm, cursor, TASK_SIZE, &memory_limit_reclaim_walk_ops, rw);
+    if (ret <= 0) {
+        rw->next = cursor;
+        if (cursor)
+            ret = walk_page_range(mm, 0, cursor, &memory_limit_reclaim_walk_ops, rw);
+        if (ret <= 0)
+            rw->next = cursor;
+    }
+    mmap_read_unlock(mm);
+
+    return rw->next;
+}
+
+/*
+ * Recupera hasta excess bytes de páginas frías del proceso actual. Con hard
+ * (la reserva ya no cabe en el límite) una pasada que solo envejeció páginas
+ * se repite de inmediato sobre el mismo tramo antes de rendirse. Puede
+ * dormir, por eso se llama fuera de RCU y vuelve a buscar la entrada para
+ * registrar el resultado. Retorna el uso del grupo ya sincronizado.
+ */
+static long memory_limit_reclaim(long usage, unsigned long excess, unsigned long cursor,
+                                 bool hard)
+{
+    struct memory_limit_reclaim_walk rw = {
+        .target = DIV_ROUND_UP(excess, PAGE_SIZE),
+    };
+    struct memory_limitation_entry *entry;
+    struct mm_struct *mm = current->mm;
+    unsigned long rss_before, rss_after, reclaimed, next;
+    unsigned int i, backoff;
+    u64 start, stall;
+
+    rw.scan_budget = max_t(unsigned long, rw.target << 3, MEMLIMIT_RECLAIM_MIN_SCAN);
+
+    rss_before = get_mm_rss(mm);
+    start = ktime_get_ns();
+    next = memory_limit_reclaim_scan(mm, &rw, cursor);
+    if (hard && !rw.nr_runs && rw.aged) {
+        rw.scan_budget = max_t(unsigned long, rw.target << 3, MEMLIMIT_RECLAIM_MIN_SCAN);
+        next = memory_limit_reclaim_scan(mm, &rw, cursor);
+    }
+    for (i = 0; i < rw.nr_runs; i++)
+        do_madvise(mm, rw.runs[i].start, rw.runs[i].end - rw.runs[i].start, MADV_PAGEOUT);
+    stall = ktime_get_ns() - start;
+    rss_after = get_mm_rss(mm);
+    reclaimed = rss_before > rss_after ? rss_before - rss_after : 0;
+
+    rcu_read_lock();
+    entry = memory_limit_find(current->tgid);
+    if (entry) {
+        backoff = reclaimed || rw.aged ? 0 : min(READ_ONCE(entry->reclaim_backoff) + 1,
+                                      (unsigned int)MEMLIMIT_RECLAIM_MAX_BACKOFF);
+        WRITE_ONCE(entry->reclaim_backoff, backoff);
+        WRITE_ONCE(entry->next_reclaim, jiffies + (MEMLIMIT_RECLAIM_INTERVAL << backoff));
+        WRITE_ONCE(entry->reclaim_cursor, next);
+        atomic64_inc(&entry->reclaim_count);
+        atomic64_add(reclaimed, &entry->reclaimed_pages);
+        atomic64_add(stall, &entry->reclaim_stall_ns);
+        usage = memory_limit_sync(&entry->charged, &entry->group->usage, mm,
+                                  READ_ONCE(entry->group->flags));
+    }
+    rcu_read_unlock();
+
+    return usage;
+}
+
+/*
+ * MEMLIMIT_THROTTLE: duerme al proceso en proporción a cuánto excede el límite
+ * suave. El retraso crece linealmente hasta max_delay_ms al llegar al límite
+ * duro y se mantiene ahí por encima de él; una señal fatal lo interrumpe.
+ */
+static void memory_limit_throttle(unsigned long overage, unsigned long span,
+                                  unsigned int max_delay_ms)
+{
+    struct memory_limitation_entry *entry;
+    unsigned long delay_ms = max_delay_ms;
+    u64 start, slept;
+
+    if (span && overage < span)
+        delay_ms = div64_u64((u64)max_delay_ms * overage, span);
+    if (!delay_ms)
+        return;
+
+    start = ktime_get_ns();
+    schedule_timeout_killable(msecs_to_jiffies(delay_ms));
+    slept = ktime_get_ns() - start;
+
+    rcu_read_lock();
+    entry = memory_limit_find(current->tgid);
+    if (entry) {
+        atomic64_inc(&entry->throttle_count);
+        atomic64_add(slept, &entry->throttle_ns);
+    }
+    rcu_read_unlock();
+}
+
+static int memory_limit_charge_pid(unsigned long bytes, enum usac_memlimit_site site)
+{
+    struct memory_limitation_entry *entry;
+    unsigned long next_reclaim, reclaim_cursor;
+    unsigned int flags, max_delay_ms;
+    size_t limit, soft_limit, watermark;
+    long usage;
+
+    rcu_read_lock();
+    entry = memory_limit_find(current->tgid);
+    if (!entry) {
+        rcu_read_unlock();
+        return 0;
+    }
+    flags = READ_ONCE(entry->group->flags);
+    limit = READ_ONCE(entry->group->memory_limit);
+    soft_limit = READ_ONCE(entry->group->soft_limit);
+    max_delay_ms = READ_ONCE(entry->group->max_delay_ms);
+    next_reclaim = READ_ONCE(entry->next_reclaim);
+    reclaim_cursor = READ_ONCE(entry->reclaim_cursor);
+    usage = memory_limit_sync(&entry->charged, &entry->group->usage, current->mm, flags);
+    rcu_read_unlock();
+
+    /*
+     * Al acercarse al límite (7/8) se recupera de forma proactiva, como mucho
+     * una vez por intervalo (con espera exponencial si no avanza); si la
+     * reserva ya no cabe se recupera siempre antes de fallar.
+     */
+    watermark = limit - (limit >> 3);
+    if ((flags & MEMLIMIT_RECLAIM) && usage + bytes > watermark &&
+        (usage + bytes > limit || time_after_eq(jiffies, next_reclaim)))
+        usage = memory_limit_reclaim(usage, usage + bytes - watermark, reclaim_cursor,
+                                     usage + bytes > limit);
+
+    // Con MEMLIMIT_THROTTLE la reserva se retrasa pero nunca se rechaza
+    if (flags & MEMLIMIT_THROTTLE) {
+        if (!soft_limit || soft_limit > limit)
+            soft_limit = limit - (limit >> 2);
+        if (usage + bytes > soft_limit)
+            memory_limit_throttle(usage + bytes - soft_limit, limit - soft_limit,
+                                  max_delay_ms);
+        return 0;
+    }
+
+    if (usage + bytes > limit) {
+        memory_limit_event_record(bytes, usage, limit, site);
+        return -ENOMEM;
+    }
+
+    return 0;
+}
+
+static int memory_limit_charge_uid(unsigned long bytes, enum usac_memlimit_site site)
+{
+    struct memory_limit_uid_member *member;
+    struct memory_limit_uid_group *group;
+    long usage;
+    int ret = 0;
+
+    // Camino rápido: no hay usuarios limitados
+    if (list_empty(&memory_limited_users))
+        return 0;
+
+    rcu_read_lock();
+    group = memory_limit_find_uid(current_uid());
+    member = memory_limit_find_uid_member(current->tgid);
+    if ((member ? member->group : NULL) != group) {
+        rcu_read_unlock();
+        memory_limit_uid_attach();
+        rcu_read_lock();
+        member = memory_limit_find_uid_member(current->tgid);
+    }
+    if (member) {
+        size_t limit = READ_ONCE(member->group->memory_limit);
+
+        usage = memory_limit_sync(&member->charged, &member->group->usage, current->mm, 0);
+        if (usage + bytes > limit) {
+            memory_limit_event_record(bytes, usage, limit, site);
+            ret = -ENOMEM;
+        }
+    }
+    rcu_read_unlock();
+
+    return ret;
+}
+
+int usac_memlimit_charge(unsigned long bytes, enum usac_memlimit_site site)
+{
+    int ret;
+
+    if (!current->mm)
+        return 0;
+
+    ret = memory_limit_charge_pid(bytes, site);
+    if (!ret)
+        ret = memory_limit_charge_uid(bytes, site);
+
+    return ret;
+}
+
+static void memory_limit_fork_uid(struct task_struct *parent, struct task_struct *child)
+{
+    struct memory_limit_uid_member *parent_member, *member;
+    bool limited;
+
+    if (list_empty(&memory_limited_users))
+        return;
+
+    // Camino rápido: el padre no aporta al límite de ningún usuario
+    rcu_read_lock();
+    limited = memory_limit_find_uid_member(parent->tgid) != NULL;
+    rcu_read_unlock();
+    if (!limited)
+        return;
+
+    member = kzalloc(sizeof(*member), GFP_ATOMIC);
+    if (!member)
+        return;  /* Se agrega en su primera reserva */
+
+    member->pid = child->tgid;
+    atomic_long_set(&member->charged, memory_limit_task_usage(child));
+
+    // El hijo comparte el usuario del padre hasta que haga setuid
+    spin_lock(&memory_limit_lock);
+    parent_member = memory_limit_find_uid_member(parent->tgid);
+    if (parent_member && !memory_limit_find_uid_member(member->pid)) {
+        member->group = parent_member->group;
+        memory_limit_add_uid_member(member);
+        member = NULL;
+    }
+    spin_unlock(&memory_limit_lock);
+
+    kfree(member);
+}
+
+/*
+ * fork/clone: si el padre pertenece a un grupo con MEMLIMIT_INHERIT el hijo
+ * se une al mismo grupo. Los hilos (CLONE_THREAD) comparten mm con el líder:
+ * no se registran ni en el grupo del padre ni en el de su usuario.
+ */
+static void memory_limit_fork_probe(void *data, struct task_struct *parent,
+                                    struct task_struct *child)
+{
+    struct memory_limitation_entry *parent_entry, *entry;
+
+    if (!thread_group_leader(child) || !child->mm)
+        return;
+
+    memory_limit_fork_uid(parent, child);
+
+    rcu_read_lock();
+    parent_entry = memory_limit_find(parent->tgid);
+    if (!parent_entry || !(READ_ONCE(parent_entry->group->flags) & MEMLIMIT_INHERIT)) {
+        rcu_read_unlock();
+        return;
+    }
+    rcu_read_unlock();
+
+    // Contexto atómico: la sonda del tracepoint no puede dormir
+    entry = kzalloc(sizeof(*entry), GFP_ATOMIC);
+    if (!entry)
+        return;
+
+    entry->pid = child->tgid;
+    atomic_long_set(&entry->charged, memory_limit_task_usage(child));
+
+    spin_lock(&memory_limit_lock);
+    /* El grupo del padre pudo eliminarse mientras reservábamos */
+    parent_entry = memory_limit_find(parent->tgid);
+    if (parent_entry && !memory_limit_find(entry->pid)) {
+        entry->group = parent_entry->group;
+        memory_limit_add_entry(entry);
+        entry = NULL;
+    }
+    spin_unlock(&memory_limit_lock);
+
+    kfree(entry);
+}
+
+/* Cuando termina el último hilo el proceso deja de aportar al grupo */
+static void memory_limit_exit_probe(void *data, struct task_struct *task)
+{
+    struct memory_limitation_entry *entry;
+    struct memory_limit_uid_member *member;
+    bool tracked;
+
+    if (atomic_read(&task->signal->live))
+        return;
+
+    // Camino rápido: el proceso no está en el registro, no se toma el lock global
+    rcu_read_lock();
+    tracked = memory_limit_find_uid_member(task->tgid) || memory_limit_find(task->tgid);
+    rcu_read_unlock();
+    if (!tracked)
+        return;
+
+    spin_lock(&memory_limit_lock);
+    member = memory_limit_find_uid_member(task->tgid);
+    if (member)
+        memory_limit_del_uid_member(member);
+
+    entry = memory_limit_find(task->tgid);
+    if (entry) {
+        atomic_long_sub(atomic_long_xchg(&entry->charged, 0), &entry->group->usage);
+        if (!entry->owner) {
+            hash_del_rcu(&entry->hnode);
+            memory_limit_nr_entries--;
+            kfree_rcu(entry, rcu);
+        }
+    }
+    spin_unlock(&memory_limit_lock);
+}
+
+static int __init memory_limit_registry_init(void)
+{
+    int err;
+
+    err = register_trace_sched_process_fork(memory_limit_fork_probe, NULL);
+    if (err)
+        return err;
+
+    err = register_trace_sched_process_exit(memory_limit_exit_probe, NULL);
+    if (err)
+        unregister_trace_sched_process_fork(memory_limit_fork_probe, NULL);
+
+    return err;
+}
+late_initcall(memory_limit_registry_init);
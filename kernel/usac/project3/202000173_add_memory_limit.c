@@ -9,32 +9,11 @@
 #include <linux/mm.h>
 #include <linux/list.h>
 
-struct memory_limitation {
-    pid_t pid;
-    size_t memory_limit;
-};
-
-struct memory_limitation_entry {
-    pid_t  pid;
-    size_t memory_limit;
-    struct list_head list; /* Para enlazar con list_head */
-};
-
-// Lista global para almacenar los procesos limitados
-LIST_HEAD(memory_limited_processes);
-
-
-static long get_process_memory_usage(struct task_struct *task)
-{
-    if (!task || !task->mm)
-        return 0;
-
-    /* total_vm está en "páginas"; lo convertimos a bytes con PAGE_SHIFT. */
-    return (long)(task->mm->total_vm << PAGE_SHIFT);
-}
+#include "202000173_memory_limit.h"
 
 SYSCALL_DEFINE2(_202000173_add_memory_limit, pid_t, process_pid, size_t, memory_limit) {
     struct memory_limitation_entry *entry;
+    struct memory_limit_group *group;
     struct task_struct *task;
     long current_usage;
 
@@ -53,33 +32,44 @@ SYSCALL_DEFINE2(_202000173_add_memory_limit, pid_t, process_pid, size_t, memory_
     if (!task) return -ESRCH;
 
      /* Obtener cuánto está usando de memoria para ver si ya excede el límite */
-    current_usage = get_process_memory_usage(task);
+    current_usage = memory_limit_task_usage(task);
     if (current_usage > (long)memory_limit) {
         put_task_struct(task);  /* Liberar referencia a la task_struct */
         return -100;
     }
 
-    /* Revisar si ya está en la lista */
-    list_for_each_entry(entry, &memory_limited_processes, list) {
-        if (entry->pid == process_pid) {
-            put_task_struct(task);
-            return -101;
-        }
-    }
-
-    // Crear nueva entrada
-    entry = kmalloc(sizeof(*entry), GFP_KERNEL);
-    if (!entry) {
+    // Crear nueva entrada y su grupo (fuera del spinlock, kmalloc puede dormir)
+    entry = kzalloc(sizeof(*entry), GFP_KERNEL);
+    group = kzalloc(sizeof(*group), GFP_KERNEL);
+    if (!entry || !group) {
+        kfree(entry);
+        kfree(group);
         put_task_struct(task);
         return -ENOMEM;
     }
 
+    group->pid = process_pid;
+    group->memory_limit = memory_limit;
+    group->max_delay_ms = MEMLIMIT_DEFAULT_MAX_DELAY_MS;
     entry->pid = process_pid;
-    entry->memory_limit = memory_limit;
+    entry->owner = true;
+    entry->group = group;
+    atomic_long_set(&entry->charged, current_usage);
+    put_task_struct(task);
+
+    spin_lock(&memory_limit_lock);
+
+    /* Revisar si ya está en la lista (registrado o heredado de otro grupo) */
+    if (memory_limit_find(process_pid)) {
+        spin_unlock(&memory_limit_lock);
+        kfree(entry);
+        kfree(group);
+        return -101;
+    }
 
     // Agregar a la lista
-    list_add(&entry->list, &memory_limited_processes);
-    put_task_struct(task);
+    memory_limit_add_entry(entry);
+    spin_unlock(&memory_limit_lock);
 
     return 0; // Éxito
 }
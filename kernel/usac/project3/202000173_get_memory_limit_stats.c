@@ -0,0 +1,46 @@
+#include <linux/kernel.h>
+#include <linux/syscalls.h>
+#include <linux/uaccess.h>
+#include <linux/slab.h>
+#include <linux/errno.h>
+
+#include "202000173_memory_limit.h"
+
+/*
+ * Syscall: _202000173_get_memory_limit_stats
+ *
+ * Versión extendida de _202000173_get_memory_limits. Retorna un registro por
+ * proceso limitado (incluye los hijos que heredaron un grupo) con el uso del
+ * grupo, el aporte del proceso y las estadísticas de recuperación de páginas.
+ * La syscall 558 conserva su formato para no romper los programas existentes.
+ */
+SYSCALL_DEFINE3(_202000173_get_memory_limit_stats, struct memory_limitation_stats __user *, u_stats_buffer, size_t, max_entries, int __user *, processes_returned)
+{
+    struct memory_limitation_stats *buffer;
+    size_t capacity;
+    int count;
+
+    /* Validar max_entries y punteros */
+    if (max_entries <= 0) return -EINVAL;
+    if (!u_stats_buffer || !processes_returned) return -EINVAL;
+
+    capacity = min_t(size_t, max_entries, READ_ONCE(memory_limit_nr_entries));
+    buffer = kcalloc(max_t(size_t, capacity, 1), sizeof(*buffer), GFP_KERNEL);
+    if (!buffer) return -ENOMEM;
+
+    spin_lock(&memory_limit_lock);
+    count = memory_limit_collect_stats(buffer, capacity);
+    spin_unlock(&memory_limit_lock);
+
+    if (copy_to_user(u_stats_buffer, buffer, count * sizeof(*buffer)) != 0) {
+        kfree(buffer);
+        return -EFAULT;
+    }
+    kfree(buffer);
+
+    if (copy_to_user(processes_returned, &count, sizeof(count)) != 0) {
+        return -EFAULT;
+    }
+
+    return count;
+}
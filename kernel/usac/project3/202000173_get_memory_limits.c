@@ -5,25 +5,14 @@
 #include <linux/errno.h>
 #include <linux/list.h>  
 
-struct memory_limitation {
-    pid_t  pid;
-    size_t memory_limit;
-};
-
-/* Estructura interna (misma definición que en 202000173_add_memory_limit.c) */
-struct memory_limitation_entry {
-    pid_t  pid;
-    size_t memory_limit;
-    struct list_head list;
-};
-
-// Lista global para almacenar los procesos limitados
-extern struct list_head memory_limited_processes;
+#include "202000173_memory_limit.h"
 
 SYSCALL_DEFINE3(_202000173_get_memory_limits, struct memory_limitation __user *, u_processes_buffer, size_t, max_entries, int __user *, processes_returned)
 {
     struct memory_limitation_entry *entry;
-    size_t count = 0;
+    struct memory_limitation *buffer;
+    size_t capacity;
+    int count = 0;
 
     /* Validar max_entries */
     if (max_entries <= 0) return -EINVAL;
@@ -31,29 +20,37 @@ SYSCALL_DEFINE3(_202000173_get_memory_limits, struct memory_limitation __user *,
     /* Validar punteros */
     if (!u_processes_buffer || !processes_returned) return -EINVAL;
 
+    /*
+     * No se puede llamar a copy_to_user() con el spinlock tomado, así que se
+     * llena un buffer temporal y se copia en bloque al final.
+     */
+    capacity = min_t(size_t, max_entries, READ_ONCE(memory_limit_nr_owners));
+    buffer = kmalloc_array(max_t(size_t, capacity, 1), sizeof(*buffer), GFP_KERNEL);
+    if (!buffer) return -ENOMEM;
+
     /* Recorrer la lista y copiar hasta max_entries */
+    spin_lock(&memory_limit_lock);
     list_for_each_entry(entry, &memory_limited_processes, list) {
-        struct memory_limitation tmp;
-
-        if (count >= max_entries)
+        if (count >= capacity)
             break;
 
-        /* Copiamos los datos a una struct temporal */
-        tmp.pid = entry->pid;
-        tmp.memory_limit = entry->memory_limit;
-
-        /* copy_to_user() retorna bytes que NO se copiaron => != 0 indica error */
-        if (copy_to_user(&u_processes_buffer[count], &tmp, sizeof(tmp)) != 0) {
-            return -EFAULT;
-        }
+        buffer[count].pid = entry->pid;
+        buffer[count].memory_limit = entry->group->memory_limit;
         count++;
     }
+    spin_unlock(&memory_limit_lock);
+
+    /* copy_to_user() retorna bytes que NO se copiaron => != 0 indica error */
+    if (copy_to_user(u_processes_buffer, buffer, count * sizeof(*buffer)) != 0) {
+        kfree(buffer);
+        return -EFAULT;
+    }
+    kfree(buffer); // Liberar memoria temporal
 
    /* Guardar la cantidad de procesos copiados en processes_returned */
     if (copy_to_user(processes_returned, &count, sizeof(count)) != 0) {
         return -EFAULT;
     }
 
-    // kfree(buffer); // Liberar memoria temporal
     return count; // Éxito
 }
@@ -0,0 +1,60 @@
+#include <linux/kernel.h>
+#include <linux/syscalls.h>
+#include <linux/uaccess.h>
+#include <linux/slab.h>
+#include <linux/errno.h>
+#include <linux/cred.h>
+#include <linux/rculist.h>
+
+#include "202000173_memory_limit.h"
+
+/*
+ * Syscall: _202000173_get_uid_memory_limits
+ *
+ * Retorna en una sola llamada el uso agregado de cada usuario limitado junto
+ * con su límite y la cantidad de procesos que aportan a ese uso.
+ */
+SYSCALL_DEFINE3(_202000173_get_uid_memory_limits, struct uid_memory_limitation __user *, u_users_buffer, size_t, max_entries, int __user *, users_returned)
+{
+    struct memory_limit_uid_group *group;
+    struct uid_memory_limitation *buffer;
+    size_t capacity;
+    int count = 0;
+
+    /* Validar max_entries y punteros */
+    if (max_entries <= 0) return -EINVAL;
+    if (!u_users_buffer || !users_returned) return -EINVAL;
+
+    capacity = min_t(size_t, max_entries, READ_ONCE(memory_limit_nr_users));
+    buffer = kmalloc_array(max_t(size_t, capacity, 1), sizeof(*buffer), GFP_KERNEL);
+    if (!buffer) return -ENOMEM;
+
+    /* Los contadores son atómicos, basta con RCU para recorrer la lista */
+    rcu_read_lock();
+    list_for_each_entry_rcu(group, &memory_limited_users, list) {
+        long usage;
+
+        if (count >= capacity)
+            break;
+
+        usage = atomic_long_read(&group->usage);
+        buffer[count].uid = from_kuid_munged(current_user_ns(), group->uid);
+        buffer[count].nr_processes = atomic_read(&group->nr_members);
+        buffer[count].memory_limit = READ_ONCE(group->memory_limit);
+        buffer[count].usage = usage > 0 ? usage : 0;
+        count++;
+    }
+    rcu_read_unlock();
+
+    if (copy_to_user(u_users_buffer, buffer, count * sizeof(*buffer)) != 0) {
+        kfree(buffer);
+        return -EFAULT;
+    }
+    kfree(buffer);
+
+    if (copy_to_user(users_returned, &count, sizeof(count)) != 0) {
+        return -EFAULT;
+    }
+
+    return count;
+}
@@ -0,0 +1,168 @@
+#ifndef _USAC_202000173_MEMORY_LIMIT_H
+#define _USAC_202000173_MEMORY_LIMIT_H
+
+#include <linux/types.h>
+#include <linux/list.h>
+#include <linux/spinlock.h>
+#include <linux/atomic.h>
+#include <linux/rcupdate.h>
+#include <linux/uidgid.h>
+#include <linux/usac_memory_limit.h>
+
+struct task_struct;
+
+/* Flags aceptados por _202000173_set_memory_limit_flags */
+#define MEMLIMIT_INHERIT     0x1  /* Los hijos creados con fork/clone se unen al grupo */
+#define MEMLIMIT_RECLAIM     0x2  /* Limita memoria residente y recupera páginas antes de fallar */
+#define MEMLIMIT_THROTTLE    0x4  /* Retrasa las reservas sobre el límite suave en vez de fallar */
+#define MEMLIMIT_VALID_FLAGS (MEMLIMIT_INHERIT | MEMLIMIT_RECLAIM | MEMLIMIT_THROTTLE)
+
+/* Valores por defecto de MEMLIMIT_THROTTLE */
+#define MEMLIMIT_DEFAULT_MAX_DELAY_MS 1000
+
+/* Estructura que se copia al espacio de usuario (syscall 558) */
+struct memory_limitation {
+    pid_t  pid;
+    size_t memory_limit;
+};
+
+/*
+ * Estadísticas por proceso (syscall 565). Incluye a los owners y a los hijos
+ * que heredaron un grupo; group_pid es el pid registrado con la syscall 557.
+ */
+struct memory_limitation_stats {
+    __s32 pid;
+    __s32 group_pid;
+    __u32 flags;
+    __u32 owner;
+    __u64 memory_limit;
+    __u64 group_usage;
+    __u64 usage;               /* Aporte de este proceso a group_usage */
+    __u64 reclaim_count;       /* Veces que se recuperaron páginas antes de fallar */
+    __u64 reclaimed_pages;
+    __u64 reclaim_stall_ns;    /* Tiempo total que el proceso esperó la recuperación */
+    __u64 soft_limit;
+    __u32 max_delay_ms;
+    __u32 reserved;
+    __u64 throttle_count;      /* Reservas retrasadas por MEMLIMIT_THROTTLE */
+    __u64 throttle_ns;         /* Tiempo total que el proceso estuvo retrasado */
+};
+
+/*
+ * Evento de violación de límite (fd de la syscall 564). dropped es el total
+ * de eventos descartados por anillo lleno al momento de registrar este.
+ */
+struct memory_limit_event {
+    __u64 timestamp_ns;
+    __s32 pid;
+    __u32 site;            /* enum usac_memlimit_site: mmap, brk o tamalloc */
+    __u64 requested;
+    __u64 usage;
+    __u64 limit;
+    __u64 dropped;
+};
+
+/*
+ * Grupo de límite. Lo crea _202000173_add_memory_limit y lo comparten el
+ * proceso registrado y, si tiene MEMLIMIT_INHERIT, todos sus descendientes.
+ * usage es la suma en bytes de lo que aporta cada miembro; cada miembro
+ * actualiza solo su diferencia, así que nunca se recorre el árbol de procesos.
+ */
+struct memory_limit_group {
+    pid_t  pid;                  /* Proceso registrado con la syscall 557 */
+    size_t memory_limit;
+    size_t soft_limit;           /* MEMLIMIT_THROTTLE: 0 equivale a 3/4 del límite */
+    unsigned int max_delay_ms;
+    unsigned int flags;
+    atomic_long_t usage;
+    struct rcu_head rcu;
+};
+
+/*
+ * Entrada por proceso (tgid). Las entradas "owner" son las registradas con la
+ * syscall 557 y además se enlazan en memory_limited_processes; el resto son
+ * hijos que heredaron el grupo y se eliminan cuando el proceso termina.
+ */
+struct memory_limitation_entry {
+    pid_t  pid;
+    bool   owner;
+    struct memory_limit_group *group;
+    atomic_long_t charged;       /* Bytes que este proceso aporta a group->usage */
+    unsigned long next_reclaim;  /* jiffies desde los que se permite otra recuperación */
+    unsigned long reclaim_cursor; /* Dirección donde sigue el barrido de páginas frías */
+    unsigned int reclaim_backoff; /* Pasadas seguidas sin recuperar ni envejecer nada */
+    atomic64_t reclaim_count;
+    atomic64_t reclaimed_pages;
+    atomic64_t reclaim_stall_ns;
+    atomic64_t throttle_count;
+    atomic64_t throttle_ns;
+    struct hlist_node hnode;     /* Tabla hash indexada por pid */
+    struct list_head list;       /* memory_limited_processes (solo owners) */
+    struct rcu_head rcu;
+};
+
+/* Estructura que se copia al espacio de usuario (syscall 563) */
+struct uid_memory_limitation {
+    uid_t  uid;
+    unsigned int nr_processes;
+    size_t memory_limit;
+    size_t usage;
+};
+
+/*
+ * Límite por usuario (syscall 562). usage es la suma de lo que aportan los
+ * procesos de ese usuario, cada uno representado por un memory_limit_uid_member.
+ */
+struct memory_limit_uid_group {
+    kuid_t uid;
+    size_t memory_limit;
+    atomic_long_t usage;
+    atomic_t nr_members;
+    struct list_head list;       /* memory_limited_users */
+    struct rcu_head rcu;
+};
+
+struct memory_limit_uid_member {
+    pid_t  pid;
+    struct memory_limit_uid_group *group;
+    atomic_long_t charged;       /* Bytes que este proceso aporta a group->usage */
+    struct hlist_node hnode;     /* Tabla hash indexada por pid */
+    struct rcu_head rcu;
+};
+
+/*
+ * Miembros reservados con GFP_KERNEL antes de registrar un límite de usuario,
+ * para no reservar memoria con memory_limit_lock tomado.
+ */
+#define MEMLIMIT_UID_PREALLOC_SLACK 16  /* Procesos que pueden aparecer mientras tanto */
+
+struct memory_limit_uid_prealloc {
+    unsigned int nr;
+    struct memory_limit_uid_member **members;
+};
+
+// Listas globales del registro y lock que protege todas sus modificaciones
+extern struct list_head memory_limited_processes;
+extern struct list_head memory_limited_users;
+extern spinlock_t memory_limit_lock;
+extern unsigned int memory_limit_nr_owners;
+extern unsigned int memory_limit_nr_entries;
+extern unsigned int memory_limit_nr_users;
+
+long memory_limit_task_usage(struct task_struct *task);
+struct memory_limitation_entry *memory_limit_find(pid_t pid);
+void memory_limit_add_entry(struct memory_limitation_entry *entry);
+void memory_limit_remove_group(struct memory_limitation_entry *owner);
+size_t memory_limit_collect_stats(struct memory_limitation_stats *buffer, size_t max_entries);
+
+struct memory_limit_uid_group *memory_limit_find_uid(kuid_t uid);
+int memory_limit_uid_prealloc(struct memory_limit_uid_prealloc *pre, kuid_t uid);
+void memory_limit_uid_prealloc_free(struct memory_limit_uid_prealloc *pre);
+void memory_limit_add_uid(struct memory_limit_uid_group *group,
+                          struct memory_limit_uid_prealloc *pre);
+void memory_limit_remove_uid(struct memory_limit_uid_group *group);
+
+void memory_limit_event_record(unsigned long requested, long usage, size_t limit,
+                               enum usac_memlimit_site site);
+
+#endif /* _USAC_202000173_MEMORY_LIMIT_H */
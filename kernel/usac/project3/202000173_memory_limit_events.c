@@ -0,0 +1,183 @@
+#include <linux/kernel.h>
+#include <linux/init.h>
+#include <linux/syscalls.h>
+#include <linux/uaccess.h>
+#include <linux/errno.h>
+#include <linux/capability.h>
+#include <linux/anon_inodes.h>
+#include <linux/fcntl.h>
+#include <linux/fs.h>
+#include <linux/poll.h>
+#include <linux/wait.h>
+#include <linux/mutex.h>
+#include <linux/ktime.h>
+#include <linux/sched.h>
+
+#include "202000173_memory_limit.h"
+
+/*
+ * Anillo de eventos de violación de límite.
+ *
+ * Los productores son los caminos de reserva que rechazan una asignación y no
+ * pueden bloquearse: reservan una posición con cmpxchg sobre head y publican
+ * el evento con la secuencia de la ranura. Si el anillo está lleno el evento
+ * se descarta y solo se incrementa memory_limit_events_dropped.
+ * El consumidor es quien lee el fd de la syscall 564, serializado por mutex.
+ */
+#define MEMLIMIT_EVENTS_SIZE 1024  /* Debe ser potencia de 2 */
+
+struct memory_limit_event_slot {
+    unsigned long seq;
+    struct memory_limit_event event;
+};
+
+static struct memory_limit_event_slot memory_limit_events[MEMLIMIT_EVENTS_SIZE];
+static atomic_long_t memory_limit_events_head;
+static unsigned long memory_limit_events_tail;  /* Protegido por memory_limit_events_mutex */
+static atomic_long_t memory_limit_events_dropped;
+static DEFINE_MUTEX(memory_limit_events_mutex);
+static DECLARE_WAIT_QUEUE_HEAD(memory_limit_events_wait);
+
+void memory_limit_event_record(unsigned long requested, long usage, size_t limit,
+                               enum usac_memlimit_site site)
+{
+    struct memory_limit_event_slot *slot;
+    long pos = atomic_long_read(&memory_limit_events_head);
+    long diff;
+
+    for (;;) {
+        slot = &memory_limit_events[pos & (MEMLIMIT_EVENTS_SIZE - 1)];
+        diff = (long)(smp_load_acquire(&slot->seq) - (unsigned long)pos);
+
+        if (diff == 0) {
+            // Ranura libre: intentar reservarla
+            if (atomic_long_try_cmpxchg(&memory_limit_events_head, &pos, pos + 1))
+                break;
+        } else if (diff < 0) {
+            // Anillo lleno: se descarta sin bloquear al proceso
+            atomic_long_inc(&memory_limit_events_dropped);
+            return;
+        } else {
+            pos = atomic_long_read(&memory_limit_events_head);
+        }
+    }
+
+    slot->event.timestamp_ns = ktime_get_real_ns();
+    slot->event.pid          = current->tgid;
+    slot->event.site         = site;
+    slot->event.requested    = requested;
+    slot->event.usage        = usage > 0 ? usage : 0;
+    slot->event.limit        = limit;
+    slot->event.dropped      = atomic_long_read(&memory_limit_events_dropped);
+    smp_store_release(&slot->seq, (unsigned long)pos + 1);
+
+    if (wq_has_sleeper(&memory_limit_events_wait))
+        wake_up_interruptible_poll(&memory_limit_events_wait, EPOLLIN | EPOLLRDNORM);
+}
+
+static bool memory_limit_events_pending(void)
+{
+    unsigned long tail = READ_ONCE(memory_limit_events_tail);
+    struct memory_limit_event_slot *slot = &memory_limit_events[tail & (MEMLIMIT_EVENTS_SIZE - 1)];
+
+    return smp_load_acquire(&slot->seq) == tail + 1;
+}
+
+/* Requiere memory_limit_events_mutex */
+static bool memory_limit_event_pop(struct memory_limit_event *event)
+{
+    unsigned long tail = memory_limit_events_tail;
+    struct memory_limit_event_slot *slot = &memory_limit_events[tail & (MEMLIMIT_EVENTS_SIZE - 1)];
+
+    if (smp_load_acquire(&slot->seq) != tail + 1)
+        return false;
+
+    *event = slot->event;
+    // Liberar la ranura para la siguiente vuelta del anillo
+    smp_store_release(&slot->seq, tail + MEMLIMIT_EVENTS_SIZE);
+    WRITE_ONCE(memory_limit_events_tail, tail + 1);
+
+    return true;
+}
+
+/* Lectura por lotes: retorna tantos eventos completos como quepan en count */
+static ssize_t memory_limit_events_read(struct file *file, char __user *buf,
+                                        size_t count, loff_t *ppos)
+{
+    struct memory_limit_event event;
+    ssize_t copied = 0;
+    int ret = 0;
+
+    if (count < sizeof(event))
+        return -EINVAL;
+
+    if (mutex_lock_interruptible(&memory_limit_events_mutex))
+        return -ERESTARTSYS;
+
+    while (!memory_limit_events_pending()) {
+        mutex_unlock(&memory_limit_events_mutex);
+
+        if (file->f_flags & O_NONBLOCK)
+            return -EAGAIN;
+        if (wait_event_interruptible(memory_limit_events_wait, memory_limit_events_pending()))
+            return -ERESTARTSYS;
+        if (mutex_lock_interruptible(&memory_limit_events_mutex))
+            return -ERESTARTSYS;
+    }
+
+    while (copied + sizeof(event) <= count && memory_limit_event_pop(&event)) {
+        if (copy_to_user(buf + copied, &event, sizeof(event))) {
+            ret = -EFAULT;
+            break;
+        }
+        copied += sizeof(event);
+    }
+    mutex_unlock(&memory_limit_events_mutex);
+
+    return copied ? copied : ret;
+}
+
+static __poll_t memory_limit_events_poll(struct file *file, poll_table *wait)
+{
+    poll_wait(file, &memory_limit_events_wait, wait);
+
+    return memory_limit_events_pending() ? EPOLLIN | EPOLLRDNORM : 0;
+}
+
+static const struct file_operations memory_limit_events_fops = {
+    .read   = memory_limit_events_read,
+    .poll   = memory_limit_events_poll,
+    .llseek = noop_llseek,
+};
+
+/*
+ * Syscall: _202000173_open_memory_limit_events
+ *
+ * Retorna un fd de solo lectura con los eventos de violación de límite.
+ * Soporta poll/epoll y cada read() entrega un lote de struct memory_limit_event.
+ * flags acepta O_NONBLOCK y O_CLOEXEC.
+ */
+SYSCALL_DEFINE1(_202000173_open_memory_limit_events, unsigned int, flags)
+{
+    // Validar flags
+    if (flags & ~(O_NONBLOCK | O_CLOEXEC))
+        return -EINVAL;
+
+    // Validar permisos (sudoers)
+    if (!capable(CAP_SYS_ADMIN))
+        return -EPERM;
+
+    return anon_inode_getfd("[memory_limit_events]", &memory_limit_events_fops,
+                            NULL, O_RDONLY | flags);
+}
+
+static int __init memory_limit_events_init(void)
+{
+    unsigned long i;
+
+    for (i = 0; i < MEMLIMIT_EVENTS_SIZE; i++)
+        memory_limit_events[i].seq = i;
+
+    return 0;
+}
+early_initcall(memory_limit_events_init);
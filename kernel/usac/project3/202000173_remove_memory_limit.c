@@ -4,17 +4,10 @@
 #include <linux/slab.h>
 #include <linux/errno.h>
 
-struct memory_limitation {
-    pid_t pid;
-    size_t memory_limit;
-    struct list_head list;  // Lista enlazada para manejar múltiples procesos
-};
-
-// Lista global para almacenar los procesos limitados
-static LIST_HEAD(memory_limited_processes);
+#include "202000173_memory_limit.h"
 
 SYSCALL_DEFINE1(_202000173_remove_memory_limit, pid_t, process_pid) {
-    struct memory_limitation *entry, *tmp;
+    struct memory_limitation_entry *entry;
 
     // Validar PID
     if (process_pid <= 0) {
@@ -26,14 +19,15 @@ SYSCALL_DEFINE1(_202000173_remove_memory_limit, pid_t, process_pid) {
         return -EPERM;
     }
 
-    // Buscar y eliminar el proceso de la lista
-    list_for_each_entry_safe(entry, tmp, &memory_limited_processes, list) {
-        if (entry->pid == process_pid) {
-            list_del(&entry->list);
-            kfree(entry);
-            return 0; // Éxito
-        }
+    // Buscar y eliminar el proceso (y los hijos que heredaron su grupo)
+    spin_lock(&memory_limit_lock);
+    entry = memory_limit_find(process_pid);
+    if (entry && entry->owner) {
+        memory_limit_remove_group(entry);
+        spin_unlock(&memory_limit_lock);
+        return 0; // Éxito
     }
+    spin_unlock(&memory_limit_lock);
 
     return -ESRCH; // Proceso no encontrado
 }
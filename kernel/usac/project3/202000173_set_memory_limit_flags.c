@@ -0,0 +1,45 @@
+#include <linux/kernel.h>
+#include <linux/syscalls.h>
+#include <linux/errno.h>
+#include <linux/capability.h>
+
+#include "202000173_memory_limit.h"
+
+/*
+ * Syscall: _202000173_set_memory_limit_flags
+ *
+ * Cambia la política de un proceso registrado con la syscall 557.
+ *   - MEMLIMIT_INHERIT: los hijos creados con fork/clone a partir de ahora se
+ *     unen al grupo del proceso y el límite se aplica al uso combinado.
+ *   - MEMLIMIT_RECLAIM: el límite se aplica a la memoria residente y, al
+ *     acercarse a él, se envían a swap páginas del proceso antes de rechazar
+ *     la reserva. El resultado se consulta con la syscall 565.
+ *   - MEMLIMIT_THROTTLE: las reservas por encima del límite suave se retrasan
+ *     en proporción al exceso en vez de fallar (parámetros en la syscall 566).
+ *
+ * Retorno: 0, -EINVAL (pid o flags inválidos), -EPERM o -ESRCH.
+ */
+SYSCALL_DEFINE2(_202000173_set_memory_limit_flags, pid_t, process_pid, unsigned int, flags) {
+    struct memory_limitation_entry *entry;
+
+    // Validar PID y flags
+    if (process_pid <= 0 || (flags & ~MEMLIMIT_VALID_FLAGS)) {
+        return -EINVAL;
+    }
+
+    // Validar permisos (sudoers)
+    if (!capable(CAP_SYS_ADMIN)) {
+        return -EPERM;
+    }
+
+    spin_lock(&memory_limit_lock);
+    entry = memory_limit_find(process_pid);
+    if (entry && entry->owner) {
+        WRITE_ONCE(entry->group->flags, flags);
+        spin_unlock(&memory_limit_lock);
+        return 0;
+    }
+    spin_unlock(&memory_limit_lock);
+
+    return -ESRCH; // Proceso no registrado
+}
@@ -0,0 +1,50 @@
+#include <linux/kernel.h>
+#include <linux/syscalls.h>
+#include <linux/errno.h>
+#include <linux/capability.h>
+
+#include "202000173_memory_limit.h"
+
+// Tope del retraso configurable por reserva (1 minuto)
+#define MEMLIMIT_MAX_DELAY_MS 60000
+
+/*
+ * Syscall: _202000173_set_memory_limit_throttle
+ *
+ * Configura MEMLIMIT_THROTTLE para un proceso registrado con la syscall 557.
+ *   - soft_limit: bytes a partir de los cuales se retrasan las reservas. Debe
+ *     ser menor o igual al límite; 0 usa 3/4 del límite.
+ *   - max_delay_ms: retraso máximo por reserva, alcanzado en el límite duro.
+ * El modo se activa con _202000173_set_memory_limit_flags(pid, MEMLIMIT_THROTTLE).
+ *
+ * Retorno: 0, -EINVAL, -EPERM o -ESRCH.
+ */
+SYSCALL_DEFINE3(_202000173_set_memory_limit_throttle, pid_t, process_pid, size_t, soft_limit, unsigned int, max_delay_ms) {
+    struct memory_limitation_entry *entry;
+    int ret = -ESRCH;
+
+    // Validar PID y retraso
+    if (process_pid <= 0 || max_delay_ms > MEMLIMIT_MAX_DELAY_MS) {
+        return -EINVAL;
+    }
+
+    // Validar permisos (sudoers)
+    if (!capable(CAP_SYS_ADMIN)) {
+        return -EPERM;
+    }
+
+    spin_lock(&memory_limit_lock);
+    entry = memory_limit_find(process_pid);
+    if (entry && entry->owner) {
+        if (soft_limit > entry->group->memory_limit) {
+            ret = -EINVAL; // El límite suave no puede superar al duro
+        } else {
+            WRITE_ONCE(entry->group->soft_limit, soft_limit);
+            WRITE_ONCE(entry->group->max_delay_ms, max_delay_ms);
+            ret = 0;
+        }
+    }
+    spin_unlock(&memory_limit_lock);
+
+    return ret;
+}
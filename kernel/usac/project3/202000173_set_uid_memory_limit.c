@@ -0,0 +1,77 @@
+#include <linux/kernel.h>
+#include <linux/syscalls.h>
+#include <linux/slab.h>
+#include <linux/errno.h>
+#include <linux/capability.h>
+#include <linux/cred.h>
+#include <linux/uidgid.h>
+#include <linux/rcupdate.h>
+
+#include "202000173_memory_limit.h"
+
+/*
+ * Syscall: _202000173_set_uid_memory_limit
+ *
+ * Registra, actualiza o elimina el límite de memoria de un usuario. El límite
+ * se aplica a la suma del uso de todos los procesos que corren con ese UID.
+ *   - memory_limit > 0: crea el límite o actualiza el existente.
+ *   - memory_limit == 0: elimina el límite del usuario.
+ *
+ * Retorno: 0, -EINVAL (uid inválido), -EPERM, -ESRCH (eliminar un usuario
+ * sin límite) o -ENOMEM.
+ */
+SYSCALL_DEFINE2(_202000173_set_uid_memory_limit, uid_t, user_id, size_t, memory_limit) {
+    struct memory_limit_uid_group *group, *new_group = NULL;
+    struct memory_limit_uid_prealloc pre = { 0 };
+    bool exists;
+    kuid_t uid;
+
+    // Validar UID
+    uid = make_kuid(current_user_ns(), user_id);
+    if (!uid_valid(uid)) {
+        return -EINVAL;
+    }
+
+    // Validar permisos (sudoers)
+    if (!capable(CAP_SYS_ADMIN)) {
+        return -EPERM;
+    }
+
+    // Reservar el grupo antes de tomar el spinlock por si hay que crearlo
+    if (memory_limit > 0) {
+        new_group = kzalloc(sizeof(*new_group), GFP_KERNEL);
+        if (!new_group) return -ENOMEM;
+        new_group->uid = uid;
+        new_group->memory_limit = memory_limit;
+
+        // Si el usuario es nuevo, también sus miembros: con el spinlock no se puede dormir
+        rcu_read_lock();
+        exists = memory_limit_find_uid(uid) != NULL;
+        rcu_read_unlock();
+        if (!exists && memory_limit_uid_prealloc(&pre, uid)) {
+            kfree(new_group);
+            return -ENOMEM;
+        }
+    }
+
+    spin_lock(&memory_limit_lock);
+    group = memory_limit_find_uid(uid);
+
+    if (memory_limit == 0) {
+        if (!group) {
+            spin_unlock(&memory_limit_lock);
+            return -ESRCH; // Usuario sin límite
+        }
+        memory_limit_remove_uid(group);
+    } else if (group) {
+        WRITE_ONCE(group->memory_limit, memory_limit); // Actualizar límite
+    } else {
+        memory_limit_add_uid(new_group, &pre);
+        new_group = NULL;
+    }
+    spin_unlock(&memory_limit_lock);
+
+    memory_limit_uid_prealloc_free(&pre);
+    kfree(new_group);
+    return 0; // Éxito
+}
@@ -4,17 +4,10 @@
 #include <linux/slab.h>
 #include <linux/errno.h>
 
-struct memory_limitation {
-    pid_t pid;
-    size_t memory_limit;
-    struct list_head list;  // Lista enlazada para manejar múltiples procesos
-};
-
-// Lista global para almacenar los procesos limitados
-static LIST_HEAD(memory_limited_processes);
+#include "202000173_memory_limit.h"
 
 SYSCALL_DEFINE2(_202000173_update_memory_limit, pid_t, process_pid, size_t, memory_limit) {
-    struct memory_limitation *entry;
+    struct memory_limitation_entry *entry;
 
     // Validar PID y límite de memoria
     if (process_pid <= 0 || memory_limit <= 0) {
@@ -27,12 +20,14 @@ SYSCALL_DEFINE2(_202000173_update_memory_limit, pid_t, process_pid, size_t, memo
     }
 
     // Buscar el proceso en la lista
-    list_for_each_entry(entry, &memory_limited_processes, list) {
-        if (entry->pid == process_pid) {
-            entry->memory_limit = memory_limit; // Actualizar límite
-            return 0; // Éxito
-        }
+    spin_lock(&memory_limit_lock);
+    entry = memory_limit_find(process_pid);
+    if (entry && entry->owner) {
+        WRITE_ONCE(entry->group->memory_limit, memory_limit); // Actualizar límite
+        spin_unlock(&memory_limit_lock);
+        return 0; // Éxito
     }
+    spin_unlock(&memory_limit_lock);
 
     return -ESRCH; // Proceso no encontrado
 }
@@ -0,0 +1,131 @@
+#ifndef _202000173_BENCH_UTIL_H
+#define _202000173_BENCH_UTIL_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Utilidades compartidas por los benchmarks y herramientas de espacio de
+ * usuario de modules/: reloj, histograma de latencias y conteo de tareas.
+ * Todo es static inline para que cada herramienta siga siendo un solo .c que
+ * se compila con un gcc directo.
+ */
+
+static inline uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Tareas del sistema según /proc/loadavg, o -1 si no se puede leer */
+static inline long system_task_count(void)
+{
+    FILE *f = fopen("/proc/loadavg", "r");
+    long running, total = -1;
+    double l1, l5, l15;
+
+    if (!f)
+        return -1;
+    if (fscanf(f, "%lf %lf %lf %ld/%ld", &l1, &l5, &l15, &running, &total) != 5)
+        total = -1;
+    fclose(f);
+    return total;
+}
+
+/*
+ * Histograma log-lineal (error menor a 3%): valores menores a 2 * HIST_SUB
+ * van en su propio bucket; de ahí en adelante cada potencia de 2 se divide en
+ * HIST_SUB buckets.
+ */
+#define HIST_SUB_BITS 5
+#define HIST_SUB      (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS  (2 * HIST_SUB + (64 - HIST_SUB_BITS - 1) * HIST_SUB)
+
+struct histogram {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint64_t buckets[HIST_BUCKETS];
+};
+
+static inline unsigned int hist_index(uint64_t v)
+{
+    unsigned int e;
+
+    if (v < 2 * HIST_SUB)
+        return v;
+    e = 63 - __builtin_clzll(v);
+    return 2 * HIST_SUB + (e - HIST_SUB_BITS - 1) * HIST_SUB +
+           (unsigned int)((v >> (e - HIST_SUB_BITS)) - HIST_SUB);
+}
+
+/* Límite inferior del bucket */
+static inline uint64_t hist_value(unsigned int idx)
+{
+    unsigned int k, e;
+
+    if (idx < 2 * HIST_SUB)
+        return idx;
+    k = idx - 2 * HIST_SUB;
+    e = k / HIST_SUB + HIST_SUB_BITS + 1;
+    return (uint64_t)(k % HIST_SUB + HIST_SUB) << (e - HIST_SUB_BITS);
+}
+
+static inline void hist_init(struct histogram *h)
+{
+    memset(h, 0, sizeof(*h));
+    h->min = UINT64_MAX;
+}
+
+static inline void hist_add(struct histogram *h, uint64_t v)
+{
+    h->buckets[hist_index(v)]++;
+    h->count++;
+    h->sum += v;
+    if (v < h->min)
+        h->min = v;
+    if (v > h->max)
+        h->max = v;
+}
+
+static inline void hist_merge(struct histogram *dst, const struct histogram *src)
+{
+    unsigned int i;
+
+    for (i = 0; i < HIST_BUCKETS; i++)
+        dst->buckets[i] += src->buckets[i];
+    dst->count += src->count;
+    dst->sum += src->sum;
+    if (src->min < dst->min)
+        dst->min = src->min;
+    if (src->max > dst->max)
+        dst->max = src->max;
+}
+
+static inline uint64_t hist_mean(const struct histogram *h)
+{
+    return h->count ? h->sum / h->count : 0;
+}
+
+static inline uint64_t hist_percentile(const struct histogram *h, double p)
+{
+    uint64_t rank = (uint64_t)(p * h->count + 0.5), seen = 0;
+    unsigned int i;
+
+    if (!h->count)
+        return 0;
+    if (rank == 0)
+        rank = 1;
+    for (i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank)
+            return hist_value(i) > h->max ? h->max : hist_value(i);
+    }
+    return h->max;
+}
+
+#endif /* _202000173_BENCH_UTIL_H */
@@ -0,0 +1,150 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+
+#include "../202000173_bench_util.h"
+
+/*
+ * Carga de I/O sintética para validar la sección [Block Devices] de
+ * /proc/202000173_module_statistics.
+ *
+ * Hace lecturas o escrituras aleatorias con O_DIRECT (sin page cache) sobre un
+ * archivo, mide por segundo las IOPS, el throughput y la latencia media que ve
+ * el programa y las imprime junto a la línea del módulo para el dispositivo
+ * indicado. Con una sola carga activa en el disco ambas columnas deben coincidir.
+ *
+ * Compilar: gcc -O2 -o bench_disk_io 202000173_bench_disk_io.c
+ * Uso:      ./bench_disk_io <archivo> <dispositivo> [read|write] [segundos] [bloque_kb] [archivo_mb]
+ * Ejemplo:  ./bench_disk_io /var/tmp/bench.dat sda read 10 4 256
+ */
+
+#define STATS_PATH "/proc/202000173_module_statistics"
+#define ALIGNMENT  4096
+
+/* Busca en la sección [Block Devices] la línea del dispositivo y la copia en line */
+static int read_module_line(const char *device, char *line, size_t size)
+{
+    FILE *f = fopen(STATS_PATH, "r");
+    char buf[512];
+    int in_section = 0, found = 0;
+    size_t len = strlen(device);
+
+    if (!f)
+        return -1;
+    while (fgets(buf, sizeof(buf), f)) {
+        if (buf[0] == '[') {
+            in_section = !strncmp(buf, "[Block Devices]", 15);
+            continue;
+        }
+        if (in_section && !strncmp(buf, device, len) && buf[len] == ' ') {
+            buf[strcspn(buf, "\n")] = '\0';
+            snprintf(line, size, "%s", buf);
+            found = 1;
+            break;
+        }
+    }
+    fclose(f);
+    return found ? 0 : -1;
+}
+
+/* Crea el archivo con el tamaño pedido para que las lecturas lleguen al disco */
+static int prepare_file(int fd, void *buf, size_t block, uint64_t file_size)
+{
+    uint64_t off;
+
+    memset(buf, 0xa5, block);
+    for (off = 0; off < file_size; off += block) {
+        if (pwrite(fd, buf, block, off) != (ssize_t)block)
+            return -1;
+    }
+    return fsync(fd);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path, *device;
+    int do_write = 0, seconds = 10, fd, sec;
+    size_t block = 4096;
+    uint64_t file_size = 256ULL << 20, nr_blocks;
+    char line[512];
+    void *buf;
+
+    if (argc < 3) {
+        fprintf(stderr, "Uso: %s <archivo> <dispositivo> [read|write] [segundos] [bloque_kb] [archivo_mb]\n",
+                argv[0]);
+        return 1;
+    }
+    path = argv[1];
+    device = argv[2];
+    if (argc > 3)
+        do_write = !strcmp(argv[3], "write");
+    if (argc > 4)
+        seconds = atoi(argv[4]);
+    if (argc > 5)
+        block = (size_t)atol(argv[5]) * 1024;
+    if (argc > 6)
+        file_size = (uint64_t)atol(argv[6]) << 20;
+    if (seconds <= 0 || block < ALIGNMENT || block % ALIGNMENT || file_size < block) {
+        fprintf(stderr, "Parámetros inválidos\n");
+        return 1;
+    }
+    nr_blocks = file_size / block;
+
+    if (posix_memalign(&buf, ALIGNMENT, block)) {
+        perror("posix_memalign");
+        return 1;
+    }
+
+    fd = open(path, O_RDWR | O_CREAT, 0600);
+    if (fd < 0 || prepare_file(fd, buf, block, file_size) < 0) {
+        perror(path);
+        return 1;
+    }
+    close(fd);
+
+    fd = open(path, O_RDWR | O_DIRECT);
+    if (fd < 0) {
+        perror("open O_DIRECT");
+        return 1;
+    }
+
+    srand(time(NULL));
+    printf("%s aleatorio, bloque %zu KB, archivo %llu MB, dispositivo %s\n",
+           do_write ? "Escritura" : "Lectura", block / 1024,
+           (unsigned long long)(file_size >> 20), device);
+    printf("%4s %9s %11s %11s | módulo\n", "seg", "iops", "KB/s", "await_us");
+
+    for (sec = 0; sec < seconds; sec++) {
+        uint64_t start = now_ns(), end = start + 1000000000ULL, t, ops = 0, lat = 0;
+
+        while ((t = now_ns()) < end) {
+            off_t off = (off_t)((uint64_t)rand() % nr_blocks) * block;
+            ssize_t n = do_write ? pwrite(fd, buf, block, off) : pread(fd, buf, block, off);
+
+            if (n != (ssize_t)block) {
+                perror(do_write ? "pwrite" : "pread");
+                return 1;
+            }
+            lat += now_ns() - t;
+            ops++;
+        }
+
+        /* El módulo muestrea cada sample_ms; su línea cubre el último periodo */
+        if (read_module_line(device, line, sizeof(line)) < 0)
+            snprintf(line, sizeof(line), "(sin datos de %s en %s)", device, STATS_PATH);
+        printf("%4d %9llu %11llu %11llu | %s\n", sec + 1,
+               (unsigned long long)ops,
+               (unsigned long long)(ops * block / 1024),
+               (unsigned long long)(ops ? lat / ops / 1000 : 0), line);
+    }
+
+    close(fd);
+    free(buf);
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "../202000173_bench_util.h"
+
+/*
+ * Benchmark de lectura + parseo de los archivos /proc de project1.
+ *
+ * Compara el costo de leer y parsear el archivo de texto (seq_printf con
+ * formato alineado) contra el archivo binario *_bin que expone cada módulo.
+ *
+ * Compilar: gcc -O2 -o bench_proc_read 202000173_bench_proc_read.c
+ * Uso:      ./bench_proc_read [iteraciones]
+ */
+
+#define STATS_BIN_MAGIC          0x41545355
+#define MEM_SNAPSHOT_BIN_MAGIC   0x4d454d55
+#define IO_THROTTLE_BIN_MAGIC    0x54494f55
+
+/* Mismas definiciones que en los módulos (versión 1) */
+struct system_stats_bin {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint64_t timestamp_ns;
+    uint64_t cpu[8];
+    uint32_t nr_windows;
+    uint32_t window_s[3];
+    uint16_t util_bp[3][8];
+    uint64_t mem_total_kb;
+    uint64_t mem_free_kb;
+    uint64_t disk_total_kb;
+    uint64_t disk_free_kb;
+    int32_t  disk_error;
+    uint32_t reserved;
+};
+
+struct mem_snapshot_bin {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint64_t timestamp_ns;
+    uint64_t page_size;
+    uint64_t total_ram;
+    uint64_t free_ram;
+    uint64_t cache_ram;
+    uint64_t buffer_ram;
+    uint64_t active_ram;
+    uint64_t inactive_ram;
+};
+
+struct io_throttle_bin {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint64_t timestamp_ns;
+    int32_t  pid;
+    int32_t  status;
+    uint64_t stats[6];
+};
+
+/* Par de archivos a comparar */
+struct bench_target {
+    const char *name;
+    const char *text_path;
+    const char *bin_path;
+    uint32_t    magic;
+    size_t      bin_size;
+};
+
+static const struct bench_target targets[] = {
+    { "statistics",
+      "/proc/202000173_module_statistics",
+      "/proc/202000173_module_statistics_bin",
+      STATS_BIN_MAGIC, sizeof(struct system_stats_bin) },
+    { "memory_snapshot",
+      "/proc/202000173_module_capture_memory_snapshot",
+      "/proc/202000173_module_capture_memory_snapshot_bin",
+      MEM_SNAPSHOT_BIN_MAGIC, sizeof(struct mem_snapshot_bin) },
+    { "io_throttle",
+      "/proc/202000173_module_get_io_throttle",
+      "/proc/202000173_module_get_io_throttle_bin",
+      IO_THROTTLE_BIN_MAGIC, sizeof(struct io_throttle_bin) },
+};
+
+static uint64_t cpu_time_ns(void)
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ((uint64_t)ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000000ULL +
+           ((uint64_t)ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * 1000ULL;
+}
+
+/*
+ * Lee el archivo de texto completo y extrae el primer número de cada línea
+ * "etiqueta: valor", como lo haría un colector. Retorna la cantidad de valores.
+ */
+static long read_parse_text(int fd, char *buf, size_t size, uint64_t *sink)
+{
+    ssize_t n, len = 0;
+    long values = 0;
+    char *line, *colon, *end;
+
+    if (lseek(fd, 0, SEEK_SET) < 0)
+        return -1;
+    while ((n = read(fd, buf + len, size - 1 - len)) > 0)
+        len += n;
+    if (n < 0)
+        return -1;
+    buf[len] = '\0';
+
+    for (line = buf; line && *line; line = end ? end + 1 : NULL) {
+        end = strchr(line, '\n');
+        colon = memchr(line, ':', end ? (size_t)(end - line) : strlen(line));
+        if (!colon)
+            continue;
+        *sink += strtoull(colon + 1, NULL, 10);
+        values++;
+    }
+    return values;
+}
+
+/* Un pread() del registro binario; el "parseo" es validar el encabezado */
+static long read_parse_bin(int fd, char *buf, size_t size, uint32_t magic, uint64_t *sink)
+{
+    ssize_t n = pread(fd, buf, size, 0);
+    uint32_t rec_magic;
+    uint64_t ts;
+
+    if (n < 16)
+        return -1;
+    memcpy(&rec_magic, buf, sizeof(rec_magic));
+    if (rec_magic != magic)
+        return -1;
+    memcpy(&ts, buf + 8, sizeof(ts));
+    *sink += ts;
+    return n;
+}
+
+static void run_target(const struct bench_target *t, long iterations)
+{
+    static char buf[1 << 20];
+    uint64_t sink = 0, wall, cpu;
+    int fd_text, fd_bin;
+    long i;
+
+    fd_text = open(t->text_path, O_RDONLY);
+    fd_bin  = open(t->bin_path, O_RDONLY);
+    if (fd_text < 0 || fd_bin < 0) {
+        printf("%-16s: módulo no cargado (%s)\n", t->name, strerror(errno));
+        if (fd_text >= 0) close(fd_text);
+        if (fd_bin >= 0) close(fd_bin);
+        return;
+    }
+
+    wall = now_ns();
+    cpu  = cpu_time_ns();
+    for (i = 0; i < iterations; i++) {
+        if (read_parse_text(fd_text, buf, sizeof(buf), &sink) < 0) {
+            perror("read text");
+            break;
+        }
+    }
+    wall = now_ns() - wall;
+    cpu  = cpu_time_ns() - cpu;
+    printf("%-16s text  : %8.0f ns/read wall  %8.0f ns/read cpu\n",
+           t->name, (double)wall / iterations, (double)cpu / iterations);
+
+    wall = now_ns();
+    cpu  = cpu_time_ns();
+    for (i = 0; i < iterations; i++) {
+        if (read_parse_bin(fd_bin, buf, t->bin_size, t->magic, &sink) < 0) {
+            fprintf(stderr, "%s: registro binario inválido\n", t->bin_path);
+            break;
+        }
+    }
+    wall = now_ns() - wall;
+    cpu  = cpu_time_ns() - cpu;
+    printf("%-16s binary: %8.0f ns/read wall  %8.0f ns/read cpu\n",
+           t->name, (double)wall / iterations, (double)cpu / iterations);
+
+    /* Evita que el compilador elimine el parseo */
+    if (sink == 42)
+        printf("\n");
+
+    close(fd_text);
+    close(fd_bin);
+}
+
+int main(int argc, char *argv[])
+{
+    long iterations = 10000;
+    size_t i;
+
+    if (argc > 1)
+        iterations = atol(argv[1]);
+    if (iterations <= 0) {
+        fprintf(stderr, "Uso: %s [iteraciones]\n", argv[0]);
+        return 1;
+    }
+
+    printf("Iteraciones por archivo: %ld\n", iterations);
+    for (i = 0; i < sizeof(targets) / sizeof(targets[0]); i++)
+        run_target(&targets[i], iterations);
+
+    return 0;
+}
@@ -0,0 +1,235 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/genetlink.h>
+
+/*
+ * Cliente del canal genetlink "usac_metrics".
+ *
+ * Se suscribe con el intervalo, umbral y máscara indicados e imprime cada
+ * registro que el kernel envía, sin volver a llamar a ninguna syscall.
+ *
+ * Compilar: gcc -O2 -o metrics_listener 202000173_metrics_listener.c
+ * Uso:      ./metrics_listener [intervalo_ms] [umbral_%] [mascara]
+ *           mascara: 1 memoria, 2 CPU, 4 I/O, 8 procesos (por defecto 15)
+ *           Suscribirse requiere CAP_NET_ADMIN (ejecutar como root).
+ */
+
+/* Mismas definiciones que kernel/usac/project1/202000173_metrics.h */
+#define USAC_METRICS_GENL_NAME "usac_metrics"
+
+enum {
+    USAC_METRICS_CMD_UNSPEC,
+    USAC_METRICS_CMD_SUBSCRIBE,
+    USAC_METRICS_CMD_UNSUBSCRIBE,
+    USAC_METRICS_CMD_GET,
+    USAC_METRICS_CMD_REPORT,
+};
+
+enum {
+    USAC_METRICS_A_UNSPEC,
+    USAC_METRICS_A_INTERVAL_MS,
+    USAC_METRICS_A_THRESHOLD,
+    USAC_METRICS_A_MASK,
+    USAC_METRICS_A_SEQ,
+    USAC_METRICS_A_TIMESTAMP,
+    USAC_METRICS_A_MEMORY,
+    USAC_METRICS_A_CPU,
+    USAC_METRICS_A_IO,
+    USAC_METRICS_A_TASKS,
+};
+
+struct usac_metrics_memory {
+    uint64_t total_kb, free_kb, swap_total_kb, swap_free_kb;
+    uint64_t cache_kb, buffer_kb, active_kb, inactive_kb;
+};
+
+struct usac_metrics_cpu {
+    uint64_t user, nice, system, idle, iowait, irq, softirq, steal;
+};
+
+struct usac_metrics_io {
+    uint64_t rchar, wchar, syscr, syscw, read_bytes, write_bytes;
+};
+
+struct usac_metrics_tasks {
+    uint64_t nr_processes, vm_kb, rss_kb;
+};
+
+#define BUF_SIZE 8192
+
+static int add_attr(struct nlmsghdr *nlh, uint16_t type, const void *data, uint16_t len)
+{
+    struct nlattr *nla = (struct nlattr *)((char *)nlh + NLMSG_ALIGN(nlh->nlmsg_len));
+
+    nla->nla_type = type;
+    nla->nla_len = NLA_HDRLEN + len;
+    memcpy((char *)nla + NLA_HDRLEN, data, len);
+    nlh->nlmsg_len = NLMSG_ALIGN(nlh->nlmsg_len) + NLA_ALIGN(nla->nla_len);
+    return 0;
+}
+
+static struct nlmsghdr *start_msg(char *buf, uint16_t family, uint8_t cmd)
+{
+    struct nlmsghdr *nlh = (struct nlmsghdr *)buf;
+    struct genlmsghdr *genl;
+
+    memset(buf, 0, BUF_SIZE);
+    nlh->nlmsg_len = NLMSG_LENGTH(GENL_HDRLEN);
+    nlh->nlmsg_type = family;
+    nlh->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+    genl = NLMSG_DATA(nlh);
+    genl->cmd = cmd;
+    genl->version = 1;
+    return nlh;
+}
+
+/* Envía el mensaje y espera el ACK; retorna 0 o -errno */
+static int transact(int fd, struct nlmsghdr *nlh, char *buf)
+{
+    struct nlmsgerr *err;
+    ssize_t n;
+
+    if (send(fd, nlh, nlh->nlmsg_len, 0) < 0)
+        return -errno;
+    n = recv(fd, buf, BUF_SIZE, 0);
+    if (n < 0)
+        return -errno;
+    nlh = (struct nlmsghdr *)buf;
+    if (nlh->nlmsg_type == NLMSG_ERROR) {
+        err = NLMSG_DATA(nlh);
+        return err->error;
+    }
+    return 0;
+}
+
+/* Resuelve el id dinámico de la familia con CTRL_CMD_GETFAMILY */
+static int resolve_family(int fd)
+{
+    char buf[BUF_SIZE];
+    struct nlmsghdr *nlh = start_msg(buf, GENL_ID_CTRL, CTRL_CMD_GETFAMILY);
+    struct nlattr *nla;
+    ssize_t n;
+    int len;
+
+    nlh->nlmsg_flags = NLM_F_REQUEST;
+    add_attr(nlh, CTRL_ATTR_FAMILY_NAME, USAC_METRICS_GENL_NAME, sizeof(USAC_METRICS_GENL_NAME));
+    if (send(fd, nlh, nlh->nlmsg_len, 0) < 0)
+        return -1;
+    n = recv(fd, buf, sizeof(buf), 0);
+    if (n < 0 || nlh->nlmsg_type == NLMSG_ERROR)
+        return -1;
+
+    nla = (struct nlattr *)((char *)NLMSG_DATA(nlh) + GENL_HDRLEN);
+    len = nlh->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN);
+    while (len >= NLA_HDRLEN && nla->nla_len >= NLA_HDRLEN) {
+        if (nla->nla_type == CTRL_ATTR_FAMILY_ID)
+            return *(uint16_t *)((char *)nla + NLA_HDRLEN);
+        len -= NLA_ALIGN(nla->nla_len);
+        nla = (struct nlattr *)((char *)nla + NLA_ALIGN(nla->nla_len));
+    }
+    return -1;
+}
+
+static void print_report(struct nlmsghdr *nlh)
+{
+    struct nlattr *nla = (struct nlattr *)((char *)NLMSG_DATA(nlh) + GENL_HDRLEN);
+    int len = nlh->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN);
+    struct usac_metrics_memory mem;
+    struct usac_metrics_cpu cpu;
+    struct usac_metrics_io io;
+    struct usac_metrics_tasks tasks;
+    uint64_t seq = 0;
+    void *data;
+
+    for (; len >= NLA_HDRLEN && nla->nla_len >= NLA_HDRLEN;
+         len -= NLA_ALIGN(nla->nla_len), nla = (struct nlattr *)((char *)nla + NLA_ALIGN(nla->nla_len))) {
+        data = (char *)nla + NLA_HDRLEN;
+        switch (nla->nla_type) {
+        case USAC_METRICS_A_SEQ:
+            memcpy(&seq, data, sizeof(seq));
+            printf("--- muestra %llu ---\n", (unsigned long long)seq);
+            break;
+        case USAC_METRICS_A_MEMORY:
+            memcpy(&mem, data, sizeof(mem));
+            printf("memoria : total %llu KB, libre %llu KB, cache %llu KB\n",
+                   (unsigned long long)mem.total_kb, (unsigned long long)mem.free_kb,
+                   (unsigned long long)mem.cache_kb);
+            break;
+        case USAC_METRICS_A_CPU:
+            memcpy(&cpu, data, sizeof(cpu));
+            printf("cpu (ns): user %llu, system %llu, idle %llu, iowait %llu\n",
+                   (unsigned long long)cpu.user, (unsigned long long)cpu.system,
+                   (unsigned long long)cpu.idle, (unsigned long long)cpu.iowait);
+            break;
+        case USAC_METRICS_A_IO:
+            memcpy(&io, data, sizeof(io));
+            printf("io      : read_bytes %llu, write_bytes %llu\n",
+                   (unsigned long long)io.read_bytes, (unsigned long long)io.write_bytes);
+            break;
+        case USAC_METRICS_A_TASKS:
+            memcpy(&tasks, data, sizeof(tasks));
+            printf("procesos: %llu, vm %llu KB, rss %llu KB\n",
+                   (unsigned long long)tasks.nr_processes, (unsigned long long)tasks.vm_kb,
+                   (unsigned long long)tasks.rss_kb);
+            break;
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    struct sockaddr_nl addr = { .nl_family = AF_NETLINK };
+    uint32_t interval = 1000, threshold = 0, mask = 15;
+    struct nlmsghdr *nlh;
+    char buf[BUF_SIZE];
+    int fd, family, ret;
+    ssize_t n;
+
+    if (argc > 1)
+        interval = atoi(argv[1]);
+    if (argc > 2)
+        threshold = atoi(argv[2]);
+    if (argc > 3)
+        mask = atoi(argv[3]);
+
+    fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_GENERIC);
+    if (fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("socket");
+        return 1;
+    }
+
+    family = resolve_family(fd);
+    if (family < 0) {
+        fprintf(stderr, "La familia %s no existe en este kernel\n", USAC_METRICS_GENL_NAME);
+        return 1;
+    }
+
+    nlh = start_msg(buf, family, USAC_METRICS_CMD_SUBSCRIBE);
+    add_attr(nlh, USAC_METRICS_A_INTERVAL_MS, &interval, sizeof(interval));
+    add_attr(nlh, USAC_METRICS_A_THRESHOLD, &threshold, sizeof(threshold));
+    add_attr(nlh, USAC_METRICS_A_MASK, &mask, sizeof(mask));
+    ret = transact(fd, nlh, buf);
+    if (ret < 0) {
+        fprintf(stderr, "SUBSCRIBE: %s\n", strerror(-ret));
+        return 1;
+    }
+    printf("Suscrito: intervalo %u ms, umbral %u%%, máscara 0x%x\n", interval, threshold, mask);
+
+    /* Cerrar el socket basta para terminar la suscripción */
+    while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) {
+        for (nlh = (struct nlmsghdr *)buf; NLMSG_OK(nlh, n); nlh = NLMSG_NEXT(nlh, n)) {
+            if (nlh->nlmsg_type == family)
+                print_report(nlh);
+        }
+        fflush(stdout);
+    }
+    perror("recv");
+    close(fd);
+    return 0;
+}
@@ -5,6 +5,8 @@
 #include <linux/vmstat.h>
 #include <linux/uaccess.h>
 #include <linux/string.h>
+#include <linux/fs.h>
+#include <linux/timekeeping.h>
 
 // *
 // LICENSE GPL Version
@@ -13,6 +15,26 @@ MODULE_LICENSE("GPL");
 MODULE_AUTHOR("KritianWHite");
 MODULE_DESCRIPTION("Módulo para mostrar snapshot de memoria en /proc/202000173_module_capture_memory_snapshot");
 
+// Registro binario de /proc/202000173_module_capture_memory_snapshot_bin.
+// Valores en páginas (page_size indica su tamaño); cambiar el formato implica
+// incrementar MEM_SNAPSHOT_BIN_VERSION.
+#define MEM_SNAPSHOT_BIN_MAGIC   0x4d454d55 // "UMEM"
+#define MEM_SNAPSHOT_BIN_VERSION 1
+
+struct mem_snapshot_bin {
+    u32 magic;
+    u16 version;
+    u16 size;
+    u64 timestamp_ns;
+    u64 page_size;
+    u64 total_ram;
+    u64 free_ram;
+    u64 cache_ram;
+    u64 buffer_ram;
+    u64 active_ram;
+    u64 inactive_ram;
+};
+
 // Función auxiliar para convertir páginas a MB y GB y mostrarlas formateadas
 static void print_memory_line(struct seq_file *m, const char *label, unsigned long pages) {
     unsigned long long bytes = (unsigned long long)pages * (unsigned long long)PAGE_SIZE;
@@ -46,6 +68,37 @@ static void fill_mem_snapshot(struct seq_file *m) {
     print_memory_line(m, "Inactive RAM", inactive_ram);
 }
 
+// read() del archivo binario: un registro completo desde la posición 0
+static ssize_t capture_mem_bin_read(struct file *file, char __user *buf, size_t count, loff_t *ppos) {
+    struct mem_snapshot_bin rec;
+    struct sysinfo i;
+
+    if (*ppos >= sizeof(rec))
+        return 0;
+
+    si_meminfo(&i);
+
+    memset(&rec, 0, sizeof(rec));
+    rec.magic        = MEM_SNAPSHOT_BIN_MAGIC;
+    rec.version      = MEM_SNAPSHOT_BIN_VERSION;
+    rec.size         = sizeof(rec);
+    rec.timestamp_ns = ktime_get_real_ns();
+    rec.page_size    = PAGE_SIZE;
+    rec.total_ram    = i.totalram;
+    rec.free_ram     = i.freeram;
+    rec.cache_ram    = global_node_page_state(NR_FILE_PAGES) - global_node_page_state(NR_SHMEM) - i.bufferram;
+    rec.buffer_ram   = i.bufferram;
+    rec.active_ram   = global_node_page_state(NR_ACTIVE_FILE) + global_node_page_state(NR_ACTIVE_ANON);
+    rec.inactive_ram = global_node_page_state(NR_INACTIVE_FILE) + global_node_page_state(NR_INACTIVE_ANON);
+
+    return simple_read_from_buffer(buf, count, ppos, &rec, sizeof(rec));
+}
+
+static const struct proc_ops capture_mem_bin_ops = {
+    .proc_read    = capture_mem_bin_read,
+    .proc_lseek   = default_llseek,
+};
+
 // Función show que se llama cuando hacemos "cat /proc/202000173_module_capture_memory_snapshot"
 static int capture_mem_show(struct seq_file *m, void *v) {
     seq_puts(m, "=========================================\n");
@@ -72,11 +125,13 @@ static const struct proc_ops capture_mem_ops = {
 
 static int __init capture_mem_init(void) {
     proc_create("202000173_module_capture_memory_snapshot", 0, NULL, &capture_mem_ops);
+    proc_create("202000173_module_capture_memory_snapshot_bin", 0, NULL, &capture_mem_bin_ops);
     pr_info("202000173_module_capture_memory_snapshot: Módulo cargado. Lee /proc/202000173_module_capture_memory_snapshot\n");
     return 0;
 }
 
 static void __exit capture_mem_exit(void) {
+    remove_proc_entry("202000173_module_capture_memory_snapshot_bin", NULL);
     remove_proc_entry("202000173_module_capture_memory_snapshot", NULL);
     pr_info("202000173_module_capture_memory_snapshot: Módulo descargado.\n");
 }
@@ -5,6 +5,8 @@
 #include <linux/sched.h>
 #include <linux/sched/signal.h>
 #include <linux/uaccess.h>
+#include <linux/fs.h>
+#include <linux/timekeeping.h>
 
 // *
 // LICENSE GPL Version
@@ -26,6 +28,43 @@ struct io_stats_user {
     u64 write_bytes;
 };
 
+// Registro binario de /proc/202000173_module_get_io_throttle_bin.
+// status es 0 si se leyó el PID, -ESRCH si no existe o -EINVAL si no hay PID configurado.
+#define IO_THROTTLE_BIN_MAGIC   0x54494f55 // "UOIT"
+#define IO_THROTTLE_BIN_VERSION 1
+
+struct io_throttle_bin {
+    u32 magic;
+    u16 version;
+    u16 size;
+    u64 timestamp_ns;
+    s32 pid;
+    s32 status;
+    struct io_stats_user stats;
+};
+
+// Copia las estadísticas I/O del PID configurado. Retorna 0 o -ESRCH.
+static int read_io_stats(struct io_stats_user *stats) {
+    struct task_struct *task;
+
+    rcu_read_lock();
+    task = pid_task(find_vpid(pid), PIDTYPE_PID);
+    if (!task) {
+        rcu_read_unlock();
+        return -ESRCH;
+    }
+
+    stats->rchar       = task->ioac.rchar;
+    stats->wchar       = task->ioac.wchar;
+    stats->syscr       = task->ioac.syscr;
+    stats->syscw       = task->ioac.syscw;
+    stats->read_bytes  = task->ioac.read_bytes;
+    stats->write_bytes = task->ioac.write_bytes;
+    rcu_read_unlock();
+
+    return 0;
+}
+
 // Función auxiliar para imprimir valores en bytes, MB y GB
 static void print_io_bytes_line(struct seq_file *m, const char *label, u64 bytes_val) {
     u64 mb = bytes_val >> 20; // divide entre 2^20 = 1048576
@@ -42,7 +81,6 @@ static void print_io_count_line(struct seq_file *m, const char *label, u64 count
 }
 
 static int io_throttle_show(struct seq_file *m, void *v) {
-    struct task_struct *task;
     struct io_stats_user stats;
 
     seq_puts(m, "=========================================\n");
@@ -55,22 +93,11 @@ static int io_throttle_show(struct seq_file *m, void *v) {
         return 0;
     }
 
-    rcu_read_lock();
-    task = pid_task(find_vpid(pid), PIDTYPE_PID);
-    if (!task) {
-        rcu_read_unlock();
+    if (read_io_stats(&stats)) {
         seq_printf(m, "El proceso con PID %d no existe.\n", pid);
         return 0;
     }
 
-    stats.rchar       = task->ioac.rchar;
-    stats.wchar       = task->ioac.wchar;
-    stats.syscr       = task->ioac.syscr;
-    stats.syscw       = task->ioac.syscw;
-    stats.read_bytes  = task->ioac.read_bytes;
-    stats.write_bytes = task->ioac.write_bytes;
-    rcu_read_unlock();
-
     seq_printf(m, "I/O Stats para PID %d:\n\n", pid);
 
     // Mostrar las métricas
@@ -97,13 +124,38 @@ static const struct proc_ops io_throttle_ops = {
     .proc_release = single_release,
 };
 
+// read() del archivo binario: un registro completo desde la posición 0
+static ssize_t io_throttle_bin_read(struct file *file, char __user *buf, size_t count, loff_t *ppos) {
+    struct io_throttle_bin rec;
+
+    if (*ppos >= sizeof(rec))
+        return 0;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.magic        = IO_THROTTLE_BIN_MAGIC;
+    rec.version      = IO_THROTTLE_BIN_VERSION;
+    rec.size         = sizeof(rec);
+    rec.timestamp_ns = ktime_get_real_ns();
+    rec.pid          = pid;
+    rec.status       = pid ? read_io_stats(&rec.stats) : -EINVAL;
+
+    return simple_read_from_buffer(buf, count, ppos, &rec, sizeof(rec));
+}
+
+static const struct proc_ops io_throttle_bin_ops = {
+    .proc_read    = io_throttle_bin_read,
+    .proc_lseek   = default_llseek,
+};
+
 static int __init io_throttle_init(void) {
     proc_create("202000173_module_get_io_throttle", 0, NULL, &io_throttle_ops);
+    proc_create("202000173_module_get_io_throttle_bin", 0, NULL, &io_throttle_bin_ops);
     pr_info("202000173_module_get_io_throttle: Módulo cargado. Use 'cat /proc/202000173_module_get_io_throttle' con pid definido.\n");
     return 0;
 }
 
 static void __exit io_throttle_exit(void) {
+    remove_proc_entry("202000173_module_get_io_throttle_bin", NULL);
     remove_proc_entry("202000173_module_get_io_throttle", NULL);
     pr_info("202000173_module_get_io_throttle: Descargando modulo.....\n");
 }
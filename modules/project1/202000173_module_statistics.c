@@ -11,6 +11,17 @@
 #include <linux/uaccess.h>
 #include <linux/namei.h>
 #include <linux/kernel_stat.h>
+#include <linux/tick.h>
+#include <linux/workqueue.h>
+#include <linux/mutex.h>
+#include <linux/slab.h>
+#include <linux/cpumask.h>
+#include <linux/math64.h>
+#include <linux/timekeeping.h>
+#include <linux/jiffies.h>
+#include <linux/string.h>
+#include <linux/blkdev.h>
+#include <linux/part_stat.h>
 
 // *
 // LICENSE GPL Version
@@ -20,11 +31,147 @@ MODULE_AUTHOR("KritianWhite");
 MODULE_DESCRIPTION("Módulo para mostrar estadísticas del sistema con un formato organizado");
 
 // Parámetro de módulo que indica la partición sobre la que se obtendrán las estadísticas de disco.
-// Por defecto se utiliza la raíz "/".
+// Por defecto se utiliza la raíz "/". Se ignora si se especifica "mounts".
+// La ruta se resuelve una sola vez al cargar el módulo, por eso es de solo lectura.
 static char *partition = "/";
-module_param(partition, charp, 0644);
+module_param(partition, charp, 0444);
 MODULE_PARM_DESC(partition, "Partition to report disk usage for");
 
+// Lista de puntos de montaje a reportar, o "all" para todos los sistemas de archivos montados.
+#define DISK_MAX_MOUNTS 32
+static char *mounts[DISK_MAX_MOUNTS];
+static int nr_mounts;
+module_param_array(mounts, charp, &nr_mounts, 0444);
+MODULE_PARM_DESC(mounts, "Mount points to report disk usage for, or \"all\"");
+
+// Vigencia (TTL) de los resultados de vfs_statfs en caché, en milisegundos.
+static unsigned int disk_ttl_ms = 5000;
+module_param(disk_ttl_ms, uint, 0444);
+MODULE_PARM_DESC(disk_ttl_ms, "How often cached statfs results are refreshed (ms)");
+
+// Periodo de muestreo de cpustat por CPU, en milisegundos.
+static unsigned int sample_ms = 1000;
+module_param(sample_ms, uint, 0444);
+MODULE_PARM_DESC(sample_ms, "CPU sampling period in milliseconds");
+
+// Ventanas (en segundos) sobre las que se publica la utilización de CPU.
+#define CPU_MAX_WINDOWS 3
+static unsigned int windows[CPU_MAX_WINDOWS] = { 1, 10, 60 };
+static int nr_windows = CPU_MAX_WINDOWS;
+module_param_array(windows, uint, &nr_windows, 0444);
+MODULE_PARM_DESC(windows, "CPU utilization windows in seconds (up to 3)");
+
+// Categorías de tiempo de CPU, en el mismo orden que get_cpu_info()
+#define CPU_STAT_CATEGORIES 8
+static const char * const cpu_stat_labels[CPU_STAT_CATEGORIES] = {
+    "User", "Nice", "System", "Idle", "IOWait", "IRQ", "SoftIRQ", "Steal",
+};
+
+// Historial circular de muestras acumuladas: cpu_history[muestra * nr_cpu_ids + cpu]
+struct cpu_sample {
+    u64 stat[CPU_STAT_CATEGORIES];
+};
+
+static struct cpu_sample *cpu_history;
+static unsigned int history_len;   // Muestras que caben en el historial
+static unsigned int history_head;  // Siguiente muestra a escribir
+static unsigned int history_count; // Muestras válidas
+static DEFINE_MUTEX(cpu_history_lock);
+static struct delayed_work cpu_sample_work;
+
+// Caché de estadísticas de disco.
+// Los puntos de montaje listados explícitamente conservan su path resuelto (la
+// referencia evita repetir kern_path en cada lectura; esos montajes solo pueden
+// desmontarse con umount -l mientras el módulo esté cargado). Con "all" no se
+// conserva ninguna referencia: cada refresco vuelve a resolver el path, y las
+// entradas de montajes que ya no aparecen en /proc/self/mounts se liberan para
+// reutilizar su posición.
+// vfs_statfs se ejecuta en un workqueue propio, un trabajo por sistema de
+// archivos, para que uno lento o colgado no detenga a los lectores del archivo
+// /proc: ellos solo copian el último valor y su antigüedad.
+struct disk_cache {
+    struct path path;            // Solo con montajes explícitos
+    struct work_struct work;
+    bool seen;                   // Con "all": apareció en el último escaneo (solo el worker)
+    spinlock_t lock;             // Protege los valores de abajo
+    bool active;                 // Falso si la posición está libre
+    unsigned int gen;            // Cambia al ocupar o liberar la posición
+    char name[64];               // Punto de montaje tal como se muestra
+    dev_t dev;                   // s_dev del superbloque al agregarlo
+    unsigned long total_kb;
+    unsigned long free_kb;
+    int err;                     // 0 o errno negativo de la última lectura
+    unsigned long refreshed;     // jiffies de la última lectura, 0 = nunca
+};
+
+static struct disk_cache disks[DISK_MAX_MOUNTS];
+static int nr_disks;             // Posiciones usadas alguna vez; solo crece y se publica con release
+static bool disk_all_mounts;
+static struct workqueue_struct *disk_wq;
+static struct delayed_work disk_refresh_work;
+static unsigned long disk_last_rescan;
+
+#define DISK_RESCAN_INTERVAL (60 * HZ) // Con "all", buscar montajes nuevos cada minuto
+
+// Dispositivos de bloque adicionales (rutas como /dev/nvme0n1) para [Block Devices].
+// Los dispositivos de los sistemas de archivos monitoreados se agregan automáticamente.
+#define BDEV_MAX_DEVICES 32
+static char *bdevs[BDEV_MAX_DEVICES];
+static int nr_bdevs_param;
+module_param_array_named(bdevs, bdevs, charp, &nr_bdevs_param, 0444);
+MODULE_PARM_DESC(bdevs, "Extra block devices to report throughput and latency for");
+
+// Contadores acumulados de la capa de bloques (los mismos de /proc/diskstats)
+struct bdev_sample {
+    u64 ios[2];                  // Índices STAT_READ y STAT_WRITE
+    u64 sectors[2];
+    u64 nsecs[2];                // Tiempo total de las peticiones completadas
+    u64 io_ticks_ms;             // Tiempo con al menos una petición en curso
+    u64 time_ns;
+};
+
+// Se guardan las dos últimas muestras; las tasas cubren el periodo sample_ms entre ellas.
+struct bdev_stats {
+    struct block_device *bdev;
+    bool opened;                 // Abierto por el módulo (parámetro bdevs o montaje con "all")
+    bool mount;                  // Agregado por un montaje con "all": se cierra cuando desaparece
+    char name[BDEVNAME_SIZE];
+    struct bdev_sample prev;
+    struct bdev_sample last;
+    unsigned int nr_samples;
+};
+
+static struct bdev_stats bdev_table[BDEV_MAX_DEVICES];
+static int nr_bdev_table;
+static DEFINE_MUTEX(bdev_lock);
+
+static void sample_block_devices(void);
+static void disk_bdev_add(const struct path *path);
+static void disk_bdev_drop(dev_t dev);
+
+// Registro binario de /proc/202000173_module_statistics_bin.
+// Formato fijo con enteros nativos: el lector hace un solo read() sin parsear texto.
+// Cualquier cambio de formato debe incrementar STATS_BIN_VERSION.
+#define STATS_BIN_MAGIC   0x41545355 // "USTA"
+#define STATS_BIN_VERSION 1
+
+struct system_stats_bin {
+    u32 magic;
+    u16 version;
+    u16 size;                                        // sizeof(struct system_stats_bin)
+    u64 timestamp_ns;                                // CLOCK_REALTIME al generar el registro
+    u64 cpu[CPU_STAT_CATEGORIES];                    // Acumulado desde el arranque (ns)
+    u32 nr_windows;
+    u32 window_s[CPU_MAX_WINDOWS];
+    u16 util_bp[CPU_MAX_WINDOWS][CPU_STAT_CATEGORIES]; // Utilización en centésimas de % (10000 = 100%)
+    u64 mem_total_kb;
+    u64 mem_free_kb;
+    u64 disk_total_kb;
+    u64 disk_free_kb;
+    s32 disk_error;                                  // 0 o errno negativo de vfs_statfs (caché)
+    u32 reserved;
+};
+
 // Función auxiliar para imprimir estadísticas de tamaño en múltiplos de KB, mostrando su equivalente en MB y GB.
 // Recibe el nombre de la métrica (label) y el valor en KB (kb_val).
 // Realiza operaciones con desplazamientos de bits para obtener MB y GB.
@@ -47,9 +194,8 @@ static void print_cpu_line(struct seq_file *m, const char *label, u64 val)
 // Se utilizan las funciones del kernel para recuperar la información total y libre.
 // Los valores se obtienen primero en bytes y luego se convierten a KB.
 // Finalmente, se imprime la información utilizando la función auxiliar que formatea la salida.
-static void get_memory_info(struct seq_file *m) {
+static void read_memory_info(unsigned long *mem_total_kb, unsigned long *mem_free_kb) {
     struct sysinfo i;
-    unsigned long mem_total_kb, mem_free_kb;
     unsigned long total_bytes, free_bytes;
 
     // Obtiene información del sistema: total y libre de RAM
@@ -60,59 +206,322 @@ static void get_memory_info(struct seq_file *m) {
     free_bytes  = i.freeram * i.mem_unit;
 
     // Convierte los valores a KB dividiendo entre 1024
-    mem_total_kb = total_bytes / 1024;
-    mem_free_kb  = free_bytes  / 1024;
+    *mem_total_kb = total_bytes / 1024;
+    *mem_free_kb  = free_bytes  / 1024;
+}
+
+static void get_memory_info(struct seq_file *m) {
+    unsigned long mem_total_kb, mem_free_kb;
+
+    read_memory_info(&mem_total_kb, &mem_free_kb);
 
     // Imprime los resultados formateados
     print_size_line(m, "Memory Total", mem_total_kb);
     print_size_line(m, "Memory Free", mem_free_kb);
 }
 
-// Obtiene información del disco de la partición especificada.
-// Primero, se resuelve la ruta de la partición usando kern_path.
-// Luego, se llama a vfs_statfs para obtener estadísticas del sistema de archivos.
-// Los valores retornados se convierten a KB y se muestran con el formato definido.
-// Retorna 0 en caso de éxito, o un código de error si falla la obtención de información.
-static int get_disk_info(struct seq_file *m) {
-    struct path path;
+// Refresca la caché de un sistema de archivos con vfs_statfs.
+// Los valores retornados se convierten a KB antes de guardarse.
+static void disk_refresh_fn(struct work_struct *work) {
+    struct disk_cache *d = container_of(work, struct disk_cache, work);
     struct kstatfs stat;
+    struct path path;
+    char name[sizeof(d->name)];
+    u64 total_bytes = 0, free_bytes = 0;
+    unsigned int gen;
+    dev_t dev;
+    bool active;
     int err;
-    u64 total_bytes, free_bytes;
-    unsigned long disk_total_kb, disk_free_kb;
 
-    // Obtiene el path interno de la partición dada
-    err = kern_path(partition, LOOKUP_FOLLOW, &path);
-    if (err)
-        return err;
+    spin_lock(&d->lock);
+    active = d->active;
+    gen = d->gen;
+    dev = d->dev;
+    memcpy(name, d->name, sizeof(name));
+    spin_unlock(&d->lock);
+    if (!active)
+        return;
 
     // Obtiene las estadísticas del sistema de archivos
-    err = vfs_statfs(&path, &stat);
-    path_put(&path);
+    if (!disk_all_mounts) {
+        err = vfs_statfs(&d->path, &stat);
+    } else {
+        // Con "all" el path se resuelve en cada refresco y se suelta enseguida.
+        // Si ya no es el mismo sistema de archivos, el montaje desapareció.
+        err = kern_path(name, LOOKUP_FOLLOW, &path);
+        if (!err) {
+            err = path.mnt->mnt_sb->s_dev == dev ? vfs_statfs(&path, &stat) : -ENOENT;
+            path_put(&path);
+        }
+    }
+    if (!err) {
+        // Calcula el total y el libre en bytes
+        total_bytes = (u64)stat.f_blocks * stat.f_bsize;
+        free_bytes  = (u64)stat.f_bfree  * stat.f_bsize;
+    }
+
+    // Si la posición se liberó o se reutilizó mientras tanto, el resultado ya no aplica
+    spin_lock(&d->lock);
+    if (d->gen == gen) {
+        d->err = err;
+        if (!err) {
+            // Convierte a KB dividiendo entre 1024
+            d->total_kb = (unsigned long)(total_bytes / 1024ULL);
+            d->free_kb  = (unsigned long)(free_bytes  / 1024ULL);
+        }
+        d->refreshed = jiffies ? jiffies : 1;
+    }
+    spin_unlock(&d->lock);
+}
+
+// Resuelve un punto de montaje y lo agrega a la caché, en la primera posición libre.
+// Solo lo llaman la inicialización y el worker de refresco, nunca en paralelo.
+// Retorna 0 o un errno negativo.
+static int disk_add_mount(const char *name) {
+    struct disk_cache *d = NULL;
+    struct path path;
+    dev_t dev;
+    int i, err;
+
+    for (i = 0; i < nr_disks; i++) {
+        if (!disks[i].active) {
+            d = &disks[i];
+            break;
+        }
+    }
+    if (!d && nr_disks >= DISK_MAX_MOUNTS)
+        return -ENOSPC;
+
+    err = kern_path(name, LOOKUP_FOLLOW, &path);
     if (err)
         return err;
+    dev = path.mnt->mnt_sb->s_dev;
 
-    // Calcula el total y el libre en bytes
-    total_bytes = (u64)stat.f_blocks * stat.f_bsize;
-    free_bytes  = (u64)stat.f_bfree  * stat.f_bsize;
+    // Un mismo sistema de archivos montado dos veces (bind mounts) se reporta una vez;
+    // la entrada existente sigue viva aunque su nombre no se haya reconocido
+    for (i = 0; i < nr_disks; i++) {
+        if (disks[i].active && disks[i].dev == dev) {
+            disks[i].seen = true;
+            path_put(&path);
+            return -EEXIST;
+        }
+    }
 
-    // Convierte a KB dividiendo entre 1024
-    disk_total_kb = (unsigned long)(total_bytes / 1024ULL);
-    disk_free_kb  = (unsigned long)(free_bytes  / 1024ULL);
+    disk_bdev_add(&path);
+    if (!d) {
+        d = &disks[nr_disks];
+        spin_lock_init(&d->lock);
+        INIT_WORK(&d->work, disk_refresh_fn);
+    }
+    if (disk_all_mounts)
+        path_put(&path);
+    else
+        d->path = path;
+    d->seen = true;
 
-    // Imprime la información de disco formateada
-    print_size_line(m, "Disk Total", disk_total_kb);
-    print_size_line(m, "Disk Free", disk_free_kb);
+    spin_lock(&d->lock);
+    strscpy(d->name, name, sizeof(d->name));
+    d->dev = dev;
+    d->gen++;
+    d->err = 0;
+    d->refreshed = 0;
+    d->active = true;
+    spin_unlock(&d->lock);
+
+    if (d == &disks[nr_disks])
+        smp_store_release(&nr_disks, nr_disks + 1);
+    queue_work(disk_wq, &d->work);
 
     return 0;
 }
 
+// Con "all": libera la posición de un montaje que ya no existe.
+static void disk_remove_mount(struct disk_cache *d) {
+    dev_t dev;
+
+    spin_lock(&d->lock);
+    d->active = false;
+    d->gen++;
+    dev = d->dev;
+    spin_unlock(&d->lock);
+
+    disk_bdev_drop(dev);
+}
+
+// Tipos de sistemas de archivos virtuales que no se reportan con "all"
+static bool disk_pseudo_fs(const char *type) {
+    static const char * const pseudo[] = {
+        "proc", "sysfs", "devtmpfs", "devpts", "cgroup", "cgroup2", "securityfs",
+        "debugfs", "tracefs", "pstore", "bpf", "mqueue", "hugetlbfs", "configfs",
+        "fusectl", "autofs", "binfmt_misc", "efivarfs", "rpc_pipefs", "nsfs",
+    };
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(pseudo); i++) {
+        if (!strcmp(type, pseudo[i]))
+            return true;
+    }
+    return false;
+}
+
+// Decodifica en el mismo buffer los escapes octales de /proc/mounts (p. ej. "\040" = espacio).
+static void disk_unescape(char *s) {
+    char *out = s;
+
+    while (*s) {
+        if (s[0] == '\\' && s[1] >= '0' && s[1] <= '7' && s[2] >= '0' && s[2] <= '7' &&
+            s[3] >= '0' && s[3] <= '7') {
+            *out++ = ((s[1] - '0') << 6) | ((s[2] - '0') << 3) | (s[3] - '0');
+            s += 4;
+        } else {
+            *out++ = *s++;
+        }
+    }
+    *out = '\0';
+}
+
+// Con "all": lee /proc/self/mounts (del espacio de nombres inicial, desde el worker),
+// agrega los puntos de montaje que aún no están en la caché y libera los que ya no
+// aparecen. Un montaje que ya está en la caché se reconoce por nombre, sin kern_path.
+static void disk_scan_all_mounts(void) {
+    struct file *file;
+    char *buf, *line, *next, *fields[3];
+    loff_t pos = 0;
+    ssize_t n, len = 0;
+    bool complete = true;
+    int i;
+
+    buf = kvmalloc(PAGE_SIZE * 16, GFP_KERNEL);
+    if (!buf)
+        return;
+
+    file = filp_open("/proc/self/mounts", O_RDONLY, 0);
+    if (IS_ERR(file)) {
+        kvfree(buf);
+        return;
+    }
+    while (len < PAGE_SIZE * 16 - 1 &&
+           (n = kernel_read(file, buf + len, PAGE_SIZE * 16 - 1 - len, &pos)) > 0)
+        len += n;
+    filp_close(file, NULL);
+    buf[len] = '\0';
+
+    // Si el archivo no cupo en el buffer, no se puede saber qué montajes desaparecieron
+    if (len == PAGE_SIZE * 16 - 1)
+        complete = false;
+
+    for (i = 0; i < nr_disks; i++)
+        disks[i].seen = false;
+
+    // Formato: dispositivo punto_de_montaje tipo opciones 0 0
+    for (line = buf; line && *line; line = next) {
+        next = strchr(line, '\n');
+        if (next)
+            *next++ = '\0';
+
+        for (i = 0; i < 3; i++)
+            fields[i] = strsep(&line, " ");
+        if (!fields[1] || !fields[2] || disk_pseudo_fs(fields[2]))
+            continue;
+
+        disk_unescape(fields[1]);
+        for (i = 0; i < nr_disks; i++) {
+            if (disks[i].active && !strncmp(disks[i].name, fields[1], sizeof(disks[i].name))) {
+                disks[i].seen = true;
+                break;
+            }
+        }
+        if (i < nr_disks)
+            continue;
+        // Sin posiciones libres se sigue marcando los existentes como vistos
+        disk_add_mount(fields[1]);
+    }
+    kvfree(buf);
+
+    for (i = 0; complete && i < nr_disks; i++) {
+        if (disks[i].active && !disks[i].seen)
+            disk_remove_mount(&disks[i]);
+    }
+}
+
+// Trabajo periódico: encola el refresco de cada sistema de archivos.
+// queue_work no vuelve a encolar un trabajo pendiente, así un statfs colgado no se acumula.
+static void disk_refresh_all_fn(struct work_struct *work) {
+    int i, count;
+
+    if (disk_all_mounts && time_after(jiffies, disk_last_rescan + DISK_RESCAN_INTERVAL)) {
+        disk_scan_all_mounts();
+        disk_last_rescan = jiffies;
+    }
+
+    count = smp_load_acquire(&nr_disks);
+    for (i = 0; i < count; i++)
+        queue_work(disk_wq, &disks[i].work);
+
+    queue_delayed_work(disk_wq, &disk_refresh_work, msecs_to_jiffies(disk_ttl_ms));
+}
+
+// Copia los últimos valores en caché de un sistema de archivos y, si name no es NULL,
+// su punto de montaje. Retorna 0, el error de vfs_statfs, -EAGAIN si aún no se ha
+// leído nunca, o -ENOENT si la posición está libre.
+static int read_disk_cache(struct disk_cache *d, char *name, unsigned long *total_kb,
+                           unsigned long *free_kb, unsigned long *age_ms) {
+    int err;
+
+    spin_lock(&d->lock);
+    if (!d->active) {
+        spin_unlock(&d->lock);
+        return -ENOENT;
+    }
+    if (name)
+        memcpy(name, d->name, sizeof(d->name));
+    err = d->refreshed ? d->err : -EAGAIN;
+    *total_kb = d->total_kb;
+    *free_kb  = d->free_kb;
+    *age_ms   = d->refreshed ? jiffies_to_msecs(jiffies - d->refreshed) : 0;
+    spin_unlock(&d->lock);
+
+    return err;
+}
+
+// Obtiene información de disco de cada sistema de archivos monitoreado desde la caché,
+// indicando hace cuánto se refrescó cada valor.
+static void get_disk_info(struct seq_file *m) {
+    unsigned long disk_total_kb, disk_free_kb, age_ms;
+    char name[sizeof(disks[0].name)];
+    int i, err, shown = 0, count = smp_load_acquire(&nr_disks);
+
+    for (i = 0; i < count; i++) {
+        err = read_disk_cache(&disks[i], name, &disk_total_kb, &disk_free_kb, &age_ms);
+        if (err == -ENOENT)
+            continue;
+
+        seq_printf(m, "%s%-20s: %s\n", shown++ ? "\n" : "", "Mount", name);
+        if (err == -EAGAIN) {
+            seq_puts(m, "Pending first refresh.\n");
+            continue;
+        }
+        if (err) {
+            seq_printf(m, "Error reading disk info (%d), refreshed %lu ms ago.\n", err, age_ms);
+            continue;
+        }
+
+        // Imprime la información de disco formateada
+        print_size_line(m, "Disk Total", disk_total_kb);
+        print_size_line(m, "Disk Free", disk_free_kb);
+        seq_printf(m, "%-20s: %lu ms ago\n", "Refreshed", age_ms);
+    }
+
+    if (!shown)
+        seq_puts(m, "Error reading disk info.\n");
+}
+
 // Obtiene información acumulada de CPU de todo el sistema.
 // Recorre todas las CPUs posibles y acumula las estadísticas de uso (user, nice, system, idle, etc.)
 // en un array temporal. Luego las imprime con el formato alineado.
 // Cada métrica corresponde a una categoría de tiempo de CPU.
-static void get_cpu_info(struct seq_file *m) {
+static void sum_cpu_stats(u64 *cpu_stats) {
     unsigned int cpu;
-    u64 cpu_stats[8] = {0}; 
     // Índices: 0:user, 1:nice, 2:system, 3:idle, 4:iowait, 5:irq, 6:softirq, 7:steal
 
     // Suma los valores de todas las CPUs
@@ -127,6 +536,12 @@ static void get_cpu_info(struct seq_file *m) {
         cpu_stats[6] += kcs->cpustat[CPUTIME_SOFTIRQ];
         cpu_stats[7] += kcs->cpustat[CPUTIME_STEAL];
     }
+}
+
+static void get_cpu_info(struct seq_file *m) {
+    u64 cpu_stats[8] = {0};
+
+    sum_cpu_stats(cpu_stats);
 
     // Imprime las estadísticas de CPU con sus etiquetas descriptivas
     print_cpu_line(m, "CPU User",    cpu_stats[0]);
@@ -139,6 +554,309 @@ static void get_cpu_info(struct seq_file *m) {
     print_cpu_line(m, "CPU Steal",   cpu_stats[7]);
 }
 
+// Lee los contadores acumulados de una CPU.
+// El tiempo idle/iowait se toma de la contabilidad NOHZ cuando está disponible,
+// porque en CPUs sin tick kcpustat no se actualiza mientras están en reposo.
+static void read_cpu_sample(unsigned int cpu, u64 *stat)
+{
+    struct kernel_cpustat kcs;
+    u64 idle_us, iowait_us;
+
+    kcpustat_cpu_fetch(&kcs, cpu);
+    idle_us   = get_cpu_idle_time_us(cpu, NULL);
+    iowait_us = get_cpu_iowait_time_us(cpu, NULL);
+
+    stat[0] = kcs.cpustat[CPUTIME_USER];
+    stat[1] = kcs.cpustat[CPUTIME_NICE];
+    stat[2] = kcs.cpustat[CPUTIME_SYSTEM];
+    stat[3] = idle_us == -1ULL ? kcs.cpustat[CPUTIME_IDLE] : idle_us * NSEC_PER_USEC;
+    stat[4] = iowait_us == -1ULL ? kcs.cpustat[CPUTIME_IOWAIT] : iowait_us * NSEC_PER_USEC;
+    stat[5] = kcs.cpustat[CPUTIME_IRQ];
+    stat[6] = kcs.cpustat[CPUTIME_SOFTIRQ];
+    stat[7] = kcs.cpustat[CPUTIME_STEAL];
+}
+
+// Trabajo periódico: guarda una muestra de todas las CPUs en el historial.
+static void cpu_sample_fn(struct work_struct *work)
+{
+    unsigned int cpu;
+
+    mutex_lock(&cpu_history_lock);
+    for_each_possible_cpu(cpu)
+        read_cpu_sample(cpu, cpu_history[history_head * nr_cpu_ids + cpu].stat);
+    history_head = (history_head + 1) % history_len;
+    if (history_count < history_len)
+        history_count++;
+    mutex_unlock(&cpu_history_lock);
+
+    sample_block_devices();
+    schedule_delayed_work(&cpu_sample_work, msecs_to_jiffies(sample_ms));
+}
+
+// Imprime un porcentaje expresado en centésimas (basis points) como "12.34%".
+static void print_percent(struct seq_file *m, u64 delta, u64 total)
+{
+    u64 bp = total ? div64_u64(delta * 10000, total) : 0;
+
+    seq_printf(m, " %6llu.%02llu%%", bp / 100, bp % 100);
+}
+
+// Calcula la diferencia de una CPU entre la muestra más reciente y la de hace "steps" muestras.
+static u64 cpu_window_delta(unsigned int cpu, unsigned int steps, u64 *delta)
+{
+    unsigned int newest = (history_head + history_len - 1) % history_len;
+    unsigned int oldest = (newest + history_len - steps) % history_len;
+    const u64 *now  = cpu_history[newest * nr_cpu_ids + cpu].stat;
+    const u64 *then = cpu_history[oldest * nr_cpu_ids + cpu].stat;
+    u64 total = 0;
+    int i;
+
+    for (i = 0; i < CPU_STAT_CATEGORIES; i++) {
+        delta[i] = now[i] > then[i] ? now[i] - then[i] : 0;
+        total += delta[i];
+    }
+    return total;
+}
+
+// Convierte una ventana en segundos a número de muestras disponibles en el historial.
+static unsigned int window_steps(unsigned int seconds)
+{
+    unsigned int steps = max(1U, seconds * 1000 / sample_ms);
+
+    return min(steps, history_count - 1);
+}
+
+// Suma las diferencias de todas las CPUs en línea para una ventana. Requiere cpu_history_lock.
+static u64 cpu_window_aggregate(unsigned int seconds, u64 *sum)
+{
+    u64 delta[CPU_STAT_CATEGORIES], total = 0;
+    unsigned int cpu, steps = window_steps(seconds);
+    int i;
+
+    for_each_online_cpu(cpu) {
+        total += cpu_window_delta(cpu, steps, delta);
+        for (i = 0; i < CPU_STAT_CATEGORIES; i++)
+            sum[i] += delta[i];
+    }
+    return total;
+}
+
+// Muestra la utilización por categoría (agregada y por CPU) para cada ventana.
+// Todo se calcula con el historial muestreado, así que una sola lectura basta.
+static void get_cpu_utilization(struct seq_file *m)
+{
+    u64 delta[CPU_STAT_CATEGORIES], sum[CPU_MAX_WINDOWS][CPU_STAT_CATEGORIES] = {};
+    u64 total[CPU_MAX_WINDOWS] = {};
+    unsigned int cpu, steps;
+    int w, i;
+
+    mutex_lock(&cpu_history_lock);
+    if (history_count < 2) {
+        mutex_unlock(&cpu_history_lock);
+        seq_puts(m, "Collecting samples...\n");
+        return;
+    }
+
+    // Agregado de todas las CPUs
+    for (w = 0; w < nr_windows; w++)
+        total[w] = cpu_window_aggregate(windows[w], sum[w]);
+
+    seq_printf(m, "%-20s:", "Window");
+    for (w = 0; w < nr_windows; w++)
+        seq_printf(m, " %8us", windows[w]);
+    seq_putc(m, '\n');
+    for (i = 0; i < CPU_STAT_CATEGORIES; i++) {
+        seq_printf(m, "CPU %-16s:", cpu_stat_labels[i]);
+        for (w = 0; w < nr_windows; w++)
+            print_percent(m, sum[w][i], total[w]);
+        seq_putc(m, '\n');
+    }
+
+    // Detalle por CPU, una tabla por ventana
+    for (w = 0; w < nr_windows; w++) {
+        steps = window_steps(windows[w]);
+        seq_printf(m, "\n[Per-CPU Utilization %us]\n%-6s", windows[w], "CPU");
+        for (i = 0; i < CPU_STAT_CATEGORIES; i++)
+            seq_printf(m, " %9s", cpu_stat_labels[i]);
+        seq_putc(m, '\n');
+
+        for_each_online_cpu(cpu) {
+            u64 cpu_total = cpu_window_delta(cpu, steps, delta);
+
+            seq_printf(m, "%-6u", cpu);
+            for (i = 0; i < CPU_STAT_CATEGORIES; i++)
+                print_percent(m, delta[i], cpu_total);
+            seq_putc(m, '\n');
+        }
+    }
+    mutex_unlock(&cpu_history_lock);
+}
+
+// Agrega un dispositivo a la tabla si no está. Requiere bdev_lock.
+static bool bdev_track(struct block_device *bdev, bool opened) {
+    struct bdev_stats *b;
+    int i;
+
+    for (i = 0; i < nr_bdev_table; i++) {
+        if (bdev_table[i].bdev == bdev)
+            return false;
+    }
+    if (nr_bdev_table >= BDEV_MAX_DEVICES)
+        return false;
+
+    b = &bdev_table[nr_bdev_table++];
+    memset(b, 0, sizeof(*b));
+    b->bdev = bdev;
+    b->opened = opened;
+    snprintf(b->name, sizeof(b->name), "%pg", bdev);
+    return true;
+}
+
+// Abre de solo lectura (sin exclusividad) los dispositivos del parámetro bdevs.
+static void bdev_open_params(void) {
+    struct block_device *bdev;
+    dev_t dev;
+    int i;
+
+    mutex_lock(&bdev_lock);
+    for (i = 0; i < nr_bdevs_param; i++) {
+        if (lookup_bdev(bdevs[i], &dev)) {
+            pr_warn("202000173_module_statistics: block device %s not found\n", bdevs[i]);
+            continue;
+        }
+        bdev = blkdev_get_by_dev(dev, BLK_OPEN_READ, NULL, NULL);
+        if (IS_ERR(bdev))
+            continue;
+        if (!bdev_track(bdev, true))
+            blkdev_put(bdev, NULL);
+    }
+    mutex_unlock(&bdev_lock);
+}
+
+static void read_bdev_sample(struct block_device *bdev, struct bdev_sample *sample) {
+    int rw;
+
+    for (rw = STAT_READ; rw <= STAT_WRITE; rw++) {
+        sample->ios[rw]     = part_stat_read(bdev, ios[rw]);
+        sample->sectors[rw] = part_stat_read(bdev, sectors[rw]);
+        sample->nsecs[rw]   = part_stat_read(bdev, nsecs[rw]);
+    }
+    sample->io_ticks_ms = jiffies_to_msecs(part_stat_read(bdev, io_ticks));
+    sample->time_ns     = ktime_get_ns();
+}
+
+// Agrega el dispositivo de un sistema de archivos monitoreado. Con montajes
+// explícitos la referencia al path en disks[] mantiene vivo a s_bdev; con "all"
+// no se conserva el path, así que el dispositivo se abre (solo lectura, sin
+// exclusividad, no impide desmontar) y se cierra en disk_bdev_drop.
+static void disk_bdev_add(const struct path *path) {
+    struct block_device *bdev = path->mnt->mnt_sb->s_bdev;
+
+    if (!bdev)
+        return;
+
+    mutex_lock(&bdev_lock);
+    if (!disk_all_mounts) {
+        bdev_track(bdev, false);
+    } else {
+        bdev = blkdev_get_by_dev(bdev->bd_dev, BLK_OPEN_READ, NULL, NULL);
+        if (!IS_ERR(bdev)) {
+            if (bdev_track(bdev, true))
+                bdev_table[nr_bdev_table - 1].mount = true;
+            else
+                blkdev_put(bdev, NULL);
+        }
+    }
+    mutex_unlock(&bdev_lock);
+}
+
+// Con "all": deja de reportar el dispositivo de un montaje que desapareció.
+static void disk_bdev_drop(dev_t dev) {
+    int i;
+
+    mutex_lock(&bdev_lock);
+    for (i = 0; i < nr_bdev_table; i++) {
+        if (bdev_table[i].mount && bdev_table[i].bdev->bd_dev == dev) {
+            blkdev_put(bdev_table[i].bdev, NULL);
+            memmove(&bdev_table[i], &bdev_table[i + 1],
+                    (nr_bdev_table - i - 1) * sizeof(bdev_table[0]));
+            nr_bdev_table--;
+            break;
+        }
+    }
+    mutex_unlock(&bdev_lock);
+}
+
+// Se ejecuta junto con el muestreo de CPU: toma una muestra de cada dispositivo.
+static void sample_block_devices(void) {
+    int i;
+
+    mutex_lock(&bdev_lock);
+    for (i = 0; i < nr_bdev_table; i++) {
+        struct bdev_stats *b = &bdev_table[i];
+
+        b->prev = b->last;
+        read_bdev_sample(b->bdev, &b->last);
+        if (b->nr_samples < 2)
+            b->nr_samples++;
+    }
+    mutex_unlock(&bdev_lock);
+}
+
+// Muestra IOPS, KB/s, peticiones en curso promedio y latencias de cada dispositivo.
+// - inflight: promedio de peticiones en curso (tiempo total de peticiones / periodo).
+// - await: latencia media por petición; svctm: tiempo ocupado por petición.
+static void get_block_device_info(struct seq_file *m) {
+    u64 d_ios[2], d_sect[2], d_nsecs[2], d_ticks, window_ns;
+    int i, rw;
+
+    mutex_lock(&bdev_lock);
+    if (!nr_bdev_table) {
+        mutex_unlock(&bdev_lock);
+        seq_puts(m, "No block devices monitored.\n");
+        return;
+    }
+
+    seq_printf(m, "%-12s %9s %9s %11s %11s %9s %11s %11s %9s %7s\n", "Device",
+               "r/s", "w/s", "rKB/s", "wKB/s", "inflight", "r_await_us", "w_await_us",
+               "svctm_us", "util");
+
+    for (i = 0; i < nr_bdev_table; i++) {
+        struct bdev_stats *b = &bdev_table[i];
+        u64 ios_total;
+
+        if (b->nr_samples < 2) {
+            seq_printf(m, "%-12s Collecting samples...\n", b->name);
+            continue;
+        }
+
+        window_ns = max_t(u64, b->last.time_ns - b->prev.time_ns, 1);
+        for (rw = STAT_READ; rw <= STAT_WRITE; rw++) {
+            d_ios[rw]   = b->last.ios[rw]     - b->prev.ios[rw];
+            d_sect[rw]  = b->last.sectors[rw] - b->prev.sectors[rw];
+            d_nsecs[rw] = b->last.nsecs[rw]   - b->prev.nsecs[rw];
+        }
+        d_ticks = b->last.io_ticks_ms - b->prev.io_ticks_ms;
+        ios_total = d_ios[STAT_READ] + d_ios[STAT_WRITE];
+
+        // Tasas por segundo: valor * 1e9 / periodo_ns. Los sectores son de 512 bytes.
+        seq_printf(m, "%-12s %9llu %9llu %11llu %11llu %5llu.%02llu %11llu %11llu %9llu ",
+                   b->name,
+                   div64_u64(d_ios[STAT_READ] * NSEC_PER_SEC, window_ns),
+                   div64_u64(d_ios[STAT_WRITE] * NSEC_PER_SEC, window_ns),
+                   div64_u64(d_sect[STAT_READ] * (NSEC_PER_SEC / 2), window_ns),
+                   div64_u64(d_sect[STAT_WRITE] * (NSEC_PER_SEC / 2), window_ns),
+                   div64_u64((d_nsecs[STAT_READ] + d_nsecs[STAT_WRITE]) * 100, window_ns) / 100,
+                   div64_u64((d_nsecs[STAT_READ] + d_nsecs[STAT_WRITE]) * 100, window_ns) % 100,
+                   d_ios[STAT_READ]  ? div64_u64(d_nsecs[STAT_READ], d_ios[STAT_READ] * NSEC_PER_USEC) : 0,
+                   d_ios[STAT_WRITE] ? div64_u64(d_nsecs[STAT_WRITE], d_ios[STAT_WRITE] * NSEC_PER_USEC) : 0,
+                   ios_total ? div64_u64(d_ticks * USEC_PER_MSEC, ios_total) : 0);
+        print_percent(m, d_ticks * NSEC_PER_MSEC, window_ns);
+        seq_putc(m, '\n');
+    }
+    mutex_unlock(&bdev_lock);
+}
+
 // Función show para el archivo /proc/202000173_module_statistics.
 // Aquí se realiza la secuencia completa de impresiones:
 // Se imprimen un encabezado, luego las estadísticas de CPU, memoria y disco,
@@ -151,15 +869,25 @@ static int system_stats_show(struct seq_file *m, void *v) {
     seq_puts(m, "[CPU Usage]\n");
     get_cpu_info(m);
 
+    seq_puts(m, "\n[CPU Utilization]\n");
+    get_cpu_utilization(m);
+
     seq_puts(m, "\n[Memory Usage]\n");
     get_memory_info(m);
 
     seq_puts(m, "\n[Disk Usage]\n");
-    if (get_disk_info(m))
-        seq_puts(m, "Error reading disk info.\n");
+    get_disk_info(m);
+
+    seq_puts(m, "\n[Block Devices]\n");
+    get_block_device_info(m);
 
     seq_puts(m, "\n=========================================\n");
-    seq_printf(m, "Partition Monitored: %s\n", partition);
+    if (disk_all_mounts)
+        seq_puts(m, "Partition Monitored: all mounted filesystems\n");
+    else if (nr_mounts)
+        seq_printf(m, "Partition Monitored: %d mount points\n", nr_mounts);
+    else
+        seq_printf(m, "Partition Monitored: %s\n", partition);
     seq_puts(m, "=========================================\n");
 
     return 0;
@@ -181,10 +909,113 @@ static const struct proc_ops system_stats_ops = {
     .proc_release = single_release,
 };
 
+// Llena el registro binario con los mismos datos que muestra el archivo de texto.
+static void fill_system_stats_bin(struct system_stats_bin *rec)
+{
+    u64 sum[CPU_STAT_CATEGORIES], total;
+    unsigned long total_kb, free_kb, age_ms;
+    int w, i, count;
+
+    memset(rec, 0, sizeof(*rec));
+    rec->magic        = STATS_BIN_MAGIC;
+    rec->version      = STATS_BIN_VERSION;
+    rec->size         = sizeof(*rec);
+    rec->timestamp_ns = ktime_get_real_ns();
+
+    sum_cpu_stats(rec->cpu);
+
+    rec->nr_windows = nr_windows;
+    mutex_lock(&cpu_history_lock);
+    for (w = 0; w < nr_windows; w++) {
+        rec->window_s[w] = windows[w];
+        if (history_count < 2)
+            continue;
+        memset(sum, 0, sizeof(sum));
+        total = cpu_window_aggregate(windows[w], sum);
+        for (i = 0; i < CPU_STAT_CATEGORIES; i++)
+            rec->util_bp[w][i] = total ? div64_u64(sum[i] * 10000, total) : 0;
+    }
+    mutex_unlock(&cpu_history_lock);
+
+    read_memory_info(&total_kb, &free_kb);
+    rec->mem_total_kb = total_kb;
+    rec->mem_free_kb  = free_kb;
+
+    // El registro binario reporta el primer sistema de archivos monitoreado
+    rec->disk_error = -ENOENT;
+    count = smp_load_acquire(&nr_disks);
+    for (i = 0; i < count && rec->disk_error == -ENOENT; i++)
+        rec->disk_error = read_disk_cache(&disks[i], NULL, &total_kb, &free_kb, &age_ms);
+    if (!rec->disk_error) {
+        rec->disk_total_kb = total_kb;
+        rec->disk_free_kb  = free_kb;
+    }
+}
+
+// read() de /proc/202000173_module_statistics_bin: un registro completo por lectura
+// desde la posición 0 (usar pread(fd, buf, size, 0) para volver a leer).
+static ssize_t system_stats_bin_read(struct file *file, char __user *buf, size_t count, loff_t *ppos) {
+    struct system_stats_bin rec;
+
+    if (*ppos >= sizeof(rec))
+        return 0;
+
+    fill_system_stats_bin(&rec);
+    return simple_read_from_buffer(buf, count, ppos, &rec, sizeof(rec));
+}
+
+static const struct proc_ops system_stats_bin_ops = {
+    .proc_read    = system_stats_bin_read,
+    .proc_lseek   = default_llseek,
+};
+
 // Función de inicialización del módulo.
 // Crea la entrada /proc/202000173_module_statistics y muestra un mensaje informando su disponibilidad.
 static int __init system_stats_init(void) {
+    unsigned int max_window = 1;
+    int w;
+
+    if (!sample_ms || nr_windows <= 0 || !disk_ttl_ms)
+        return -EINVAL;
+
+    // El historial cubre la ventana más larga más una muestra de referencia
+    for (w = 0; w < nr_windows; w++)
+        max_window = max(max_window, windows[w]);
+    history_len = max(2U, max_window * 1000 / sample_ms + 1);
+    cpu_history = kvcalloc((size_t)history_len * nr_cpu_ids, sizeof(*cpu_history), GFP_KERNEL);
+    if (!cpu_history)
+        return -ENOMEM;
+
+    disk_wq = alloc_workqueue("202000173_disk_stats", WQ_UNBOUND, 0);
+    if (!disk_wq) {
+        kvfree(cpu_history);
+        return -ENOMEM;
+    }
+
+    // Resuelve una sola vez los puntos de montaje configurados
+    disk_all_mounts = nr_mounts == 1 && !strcmp(mounts[0], "all");
+    if (disk_all_mounts) {
+        disk_scan_all_mounts();
+        disk_last_rescan = jiffies;
+    } else if (nr_mounts) {
+        for (w = 0; w < nr_mounts; w++) {
+            if (disk_add_mount(mounts[w]) == -ENOENT)
+                pr_warn("202000173_module_statistics: mount point %s not found\n", mounts[w]);
+        }
+    } else if (disk_add_mount(partition)) {
+        pr_warn("202000173_module_statistics: partition %s not found\n", partition);
+    }
+
+    INIT_DELAYED_WORK(&disk_refresh_work, disk_refresh_all_fn);
+    queue_delayed_work(disk_wq, &disk_refresh_work, msecs_to_jiffies(disk_ttl_ms));
+
+    bdev_open_params();
+
+    INIT_DELAYED_WORK(&cpu_sample_work, cpu_sample_fn);
+    schedule_delayed_work(&cpu_sample_work, 0);
+
     proc_create("202000173_module_statistics", 0, NULL, &system_stats_ops);
+    proc_create("202000173_module_statistics_bin", 0, NULL, &system_stats_bin_ops);
     pr_info("202000173_module_statistics module loaded. Read /proc/202000173_module_statistics.\n");
     return 0;
 }
@@ -192,7 +1023,24 @@ static int __init system_stats_init(void) {
 // Función de limpieza del módulo.
 // Elimina la entrada /proc/202000173_module_statistics y muestra un mensaje de descarte.
 static void __exit system_stats_exit(void) {
+    int w;
+
+    remove_proc_entry("202000173_module_statistics_bin", NULL);
     remove_proc_entry("202000173_module_statistics", NULL);
+    cancel_delayed_work_sync(&cpu_sample_work);
+    kvfree(cpu_history);
+
+    // destroy_workqueue espera a que terminen los statfs en curso
+    cancel_delayed_work_sync(&disk_refresh_work);
+    destroy_workqueue(disk_wq);
+    for (w = 0; w < nr_disks && !disk_all_mounts; w++)
+        path_put(&disks[w].path);
+
+    // Después del workqueue: con "all" el escaneo de montajes también abre dispositivos
+    for (w = 0; w < nr_bdev_table; w++) {
+        if (bdev_table[w].opened)
+            blkdev_put(bdev_table[w].bdev, NULL);
+    }
     pr_info("202000173_module_statistics module unloaded.\n");
 }
 
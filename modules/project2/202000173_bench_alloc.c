@@ -0,0 +1,259 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "../202000173_bench_util.h"
+
+/*
+ * Benchmark de allocator: compara glibc contra libtamalloc_preload.so
+ * (202000173_tamalloc_preload.c) con la misma carga.
+ *
+ * Cada hilo mantiene -k bloques vivos y en cada operación reemplaza uno al
+ * azar (free + malloc o calloc). Una fracción -L de las reservas es grande
+ * (entre el umbral y -M bytes) y el resto pequeña (16 a 4096 bytes). Se
+ * escribe un byte por página de cada bloque nuevo, como haría una
+ * aplicación que usa lo que reserva, así que el costo de los fallos de
+ * página y del cero de las páginas entra en la medición.
+ *
+ * Con -l <ruta de la biblioteca> el programa se ejecuta a sí mismo dos veces,
+ * sin y con LD_PRELOAD, e imprime ambas líneas y la razón entre ellas. Sin -l
+ * mide solo el allocator con el que se ejecutó.
+ *
+ * Compilar: gcc -O2 -pthread -o bench_alloc 202000173_bench_alloc.c
+ * Uso:      ./bench_alloc [-l libtamalloc_preload.so] [-t hilos] [-n operaciones]
+ *                         [-k vivos] [-L fracción_grande] [-M max_bytes] [-c fracción_calloc]
+ * Ejemplo:  ./bench_alloc -l ./libtamalloc_preload.so -t 4 -n 200000 -L 0.05 -M 4194304
+ */
+
+#define SMALL_MIN      16
+#define SMALL_MAX      4096
+#define CHILD_ENV      "BENCH_ALLOC_CHILD"
+
+/* Configuración */
+static const char *opt_lib;
+static int opt_threads = 4;
+static long opt_ops = 100000;
+static int opt_live = 256;
+static double opt_large = 0.05;
+static size_t opt_large_min = 128 * 1024;
+static size_t opt_large_max = 4UL << 20;
+static double opt_calloc = 0.25;
+
+struct alloc_thread {
+    pthread_t thread;
+    unsigned int seed;
+    uint64_t elapsed_ns;
+    uint64_t alloc_ns;      /* Solo malloc/calloc/free, sin tocar páginas */
+    uint64_t large;
+    uint64_t bytes;
+};
+
+static long page_size;
+static pthread_barrier_t start_barrier;
+
+static double rand_unit(unsigned int *seed)
+{
+    return rand_r(seed) / (RAND_MAX + 1.0);
+}
+
+static size_t pick_size(struct alloc_thread *t)
+{
+    if (rand_unit(&t->seed) < opt_large) {
+        t->large++;
+        return opt_large_min + (size_t)(rand_unit(&t->seed) * (opt_large_max - opt_large_min));
+    }
+    return SMALL_MIN + (size_t)(rand_unit(&t->seed) * (SMALL_MAX - SMALL_MIN));
+}
+
+static void *alloc_thread_fn(void *arg)
+{
+    struct alloc_thread *t = arg;
+    char **live = calloc(opt_live, sizeof(*live));
+    uint64_t start, op_start;
+    size_t size, off;
+    long i;
+    int slot;
+
+    if (!live)
+        return NULL;
+    pthread_barrier_wait(&start_barrier);
+    start = now_ns();
+    for (i = 0; i < opt_ops; i++) {
+        slot = rand_r(&t->seed) % opt_live;
+        size = pick_size(t);
+
+        op_start = now_ns();
+        free(live[slot]);
+        if (rand_unit(&t->seed) < opt_calloc)
+            live[slot] = calloc(1, size);
+        else
+            live[slot] = malloc(size);
+        t->alloc_ns += now_ns() - op_start;
+        if (!live[slot])
+            continue;
+
+        for (off = 0; off < size; off += page_size)
+            live[slot][off] = (char)i;
+        live[slot][size - 1] = (char)i;
+        t->bytes += size;
+    }
+    t->elapsed_ns = now_ns() - start;
+    for (slot = 0; slot < opt_live; slot++)
+        free(live[slot]);
+    free(live);
+    return NULL;
+}
+
+/* Corre la carga con el allocator actual e imprime una línea clave=valor */
+static int run_workload(const char *label)
+{
+    struct alloc_thread *threads = calloc(opt_threads, sizeof(*threads));
+    struct rusage usage;
+    uint64_t wall = 0, alloc_ns = 0, large = 0, bytes = 0, start;
+    long total = (long)opt_threads * opt_ops;
+    int i;
+
+    if (!threads)
+        return 1;
+    pthread_barrier_init(&start_barrier, NULL, opt_threads + 1);
+    for (i = 0; i < opt_threads; i++) {
+        threads[i].seed = 12345 + i;
+        pthread_create(&threads[i].thread, NULL, alloc_thread_fn, &threads[i]);
+    }
+    start = now_ns();
+    pthread_barrier_wait(&start_barrier);
+    for (i = 0; i < opt_threads; i++) {
+        pthread_join(threads[i].thread, NULL);
+        alloc_ns += threads[i].alloc_ns;
+        large += threads[i].large;
+        bytes += threads[i].bytes;
+    }
+    wall = now_ns() - start;
+    pthread_barrier_destroy(&start_barrier);
+    getrusage(RUSAGE_SELF, &usage);
+
+    printf("allocator=%s threads=%d ops=%ld large=%llu ops_per_sec=%.0f ns_per_alloc=%.1f "
+           "mb_per_sec=%.1f minflt=%ld maxrss_kb=%ld user_ms=%ld sys_ms=%ld\n",
+           label, opt_threads, total, (unsigned long long)large,
+           total * 1e9 / wall, (double)alloc_ns / total, bytes / 1048576.0 * 1e9 / wall,
+           usage.ru_minflt, usage.ru_maxrss,
+           usage.ru_utime.tv_sec * 1000 + usage.ru_utime.tv_usec / 1000,
+           usage.ru_stime.tv_sec * 1000 + usage.ru_stime.tv_usec / 1000);
+    fflush(stdout);
+    free(threads);
+    return 0;
+}
+
+/* Ejecuta este mismo programa como hijo (con o sin LD_PRELOAD) y lee su línea */
+static int run_child(char **argv, const char *preload, char *line, size_t size)
+{
+    int fds[2], status;
+    pid_t pid;
+    FILE *f;
+
+    if (pipe(fds) < 0)
+        return -1;
+    pid = fork();
+    if (pid < 0)
+        return -1;
+    if (pid == 0) {
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+        setenv(CHILD_ENV, preload ? "tamalloc" : "glibc", 1);
+        if (preload)
+            setenv("LD_PRELOAD", preload, 1);
+        else
+            unsetenv("LD_PRELOAD");
+        execv("/proc/self/exe", argv);
+        _exit(127);
+    }
+    close(fds[1]);
+    f = fdopen(fds[0], "r");
+    line[0] = '\0';
+    if (f) {
+        if (!fgets(line, size, f))
+            line[0] = '\0';
+        fclose(f);
+    }
+    waitpid(pid, &status, 0);
+    return line[0] ? 0 : -1;
+}
+
+static double field(const char *line, const char *key)
+{
+    const char *p = strstr(line, key);
+
+    return p ? atof(p + strlen(key)) : 0;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Uso: %s [opciones]\n"
+            "  -l R   biblioteca de preload; compara glibc contra ella\n"
+            "  -t N   hilos (%d)\n"
+            "  -n N   operaciones por hilo (%ld)\n"
+            "  -k N   bloques vivos por hilo (%d)\n"
+            "  -L F   fracción de reservas grandes (%.2f)\n"
+            "  -m N   tamaño mínimo de una reserva grande (%zu)\n"
+            "  -M N   tamaño máximo de una reserva grande (%zu)\n"
+            "  -c F   fracción de reservas con calloc (%.2f)\n",
+            prog, opt_threads, opt_ops, opt_live, opt_large, opt_large_min, opt_large_max, opt_calloc);
+}
+
+int main(int argc, char *argv[])
+{
+    char base[512], pre[512];
+    const char *child;
+    int opt;
+
+    page_size = sysconf(_SC_PAGESIZE);
+    while ((opt = getopt(argc, argv, "l:t:n:k:L:m:M:c:h")) != -1) {
+        switch (opt) {
+        case 'l': opt_lib = optarg; break;
+        case 't': opt_threads = atoi(optarg); break;
+        case 'n': opt_ops = atol(optarg); break;
+        case 'k': opt_live = atoi(optarg); break;
+        case 'L': opt_large = atof(optarg); break;
+        case 'm': opt_large_min = (size_t)atol(optarg); break;
+        case 'M': opt_large_max = (size_t)atol(optarg); break;
+        case 'c': opt_calloc = atof(optarg); break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (opt_threads <= 0 || opt_ops <= 0 || opt_live <= 0 || opt_large < 0 || opt_large > 1 ||
+        opt_calloc < 0 || opt_calloc > 1 || opt_large_min > opt_large_max || !opt_large_min) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    child = getenv(CHILD_ENV);
+    if (child || !opt_lib)
+        return run_workload(child ? child : "actual");
+
+    if (run_child(argv, NULL, base, sizeof(base)) < 0 ||
+        run_child(argv, opt_lib, pre, sizeof(pre)) < 0) {
+        fprintf(stderr, "No se pudo ejecutar la carga\n");
+        return 1;
+    }
+    fputs(base, stdout);
+    fputs(pre, stdout);
+    printf("speedup ops_per_sec=%.2fx ns_per_alloc=%.2fx sys_ms=%.2fx minflt=%.2fx\n",
+           field(pre, "ops_per_sec=") / field(base, "ops_per_sec="),
+           field(base, "ns_per_alloc=") / field(pre, "ns_per_alloc="),
+           field(pre, "sys_ms=") / (field(base, "sys_ms=") ? field(base, "sys_ms=") : 1),
+           field(pre, "minflt=") / (field(base, "minflt=") ? field(base, "minflt=") : 1));
+    return 0;
+}
@@ -0,0 +1,398 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#include "../202000173_bench_util.h"
+
+/*
+ * Benchmark de fallos de página para el cero perezoso de tamalloc.
+ *
+ * _202000173_tamalloc_stats (552) crea un mapeo anónimo con MAP_NORESERVE:
+ * cada página se pone en cero la primera vez que se toca, dentro del fallo
+ * de página. Este programa mide ese costo con N hilos tocando regiones y lo
+ * compara contra mmap directo y calloc.
+ *
+ * Patrones de acceso (-p):
+ *   - private:    cada hilo tiene su propia región.
+ *   - split:      una región compartida, cada hilo toca su porción contigua.
+ *   - interleave: una región compartida, el hilo i toca los bloques i, i + N,
+ *                 i + 2N, ... así que hilos vecinos fallan sobre la misma
+ *                 tabla de páginas (y la misma página si -S < tamaño de página).
+ *
+ * Por cada modo se reporta: fallos/s (minflt de getrusage por hilo), ns por
+ * fallo (tiempo de los hilos / fallos), tiempo de la reserva y, si el kernel
+ * tiene CONFIG_LOCK_STAT, las contenciones y el tiempo de espera de
+ * mmap_lock durante la fase de fallos (/proc/lock_stat). Desde 6.4 los fallos
+ * anónimos toman normalmente el lock por VMA, así que mmap_lock solo debería
+ * aparecer cuando el fallo cae de vuelta al camino lento.
+ *
+ * Compilar: gcc -O2 -pthread -o bench_page_faults 202000173_bench_page_faults.c
+ * Uso:      ./bench_page_faults [-t hilos] [-s mb_por_hilo] [-S stride] [-p patrón]
+ *                               [-m tamalloc,mmap,calloc] [-r repeticiones] [-f text|json|csv]
+ * Ejemplo:  ./bench_page_faults -t 8 -s 256 -S 4096 -p interleave -r 5
+ */
+
+#ifndef __NR__202000173_tamalloc_stats
+#define __NR__202000173_tamalloc_stats 552
+#endif
+
+#define LOCK_STAT_PATH "/proc/lock_stat"
+
+enum pattern { PATTERN_PRIVATE, PATTERN_SPLIT, PATTERN_INTERLEAVE };
+enum mode { MODE_TAMALLOC, MODE_MMAP, MODE_CALLOC, NR_MODES };
+
+static const char *pattern_names[] = { "private", "split", "interleave" };
+static const char *mode_names[] = { "tamalloc", "mmap", "calloc" };
+
+/* Configuración */
+static int opt_threads = 4;
+static size_t opt_region = 64UL << 20;   /* Bytes por hilo */
+static size_t opt_stride;                /* Por defecto, el tamaño de página */
+static enum pattern opt_pattern = PATTERN_PRIVATE;
+static int opt_modes[NR_MODES] = { 1, 1, 1 };
+static int opt_reps = 3;
+static const char *opt_format = "text";
+
+struct fault_thread {
+    pthread_t thread;
+    int index;
+    volatile char *base;
+    size_t first;
+    size_t end;
+    size_t step;
+    uint64_t elapsed_ns;
+    uint64_t touches;
+    long minflt;
+};
+
+static pthread_barrier_t start_barrier;
+
+static void *fault_thread_fn(void *arg)
+{
+    struct fault_thread *t = arg;
+    struct rusage before, after;
+    uint64_t start, touches = 0;
+    size_t off;
+
+    pthread_barrier_wait(&start_barrier);
+    getrusage(RUSAGE_THREAD, &before);
+    start = now_ns();
+    for (off = t->first; off < t->end; off += t->step) {
+        t->base[off] = 1;
+        touches++;
+    }
+    t->elapsed_ns = now_ns() - start;
+    getrusage(RUSAGE_THREAD, &after);
+    t->touches = touches;
+    t->minflt = after.ru_minflt - before.ru_minflt;
+    return NULL;
+}
+
+/*
+ * Suma de contenciones y tiempo de espera (us) de las clases de mmap_lock.
+ * Retorna -1 si el kernel no tiene CONFIG_LOCK_STAT o no hay permiso.
+ */
+static int read_mmap_lock_stat(uint64_t *contentions, double *wait_us)
+{
+    FILE *f = fopen(LOCK_STAT_PATH, "r");
+    char line[512], *name, *p;
+    unsigned long long bounces, cont;
+    double wmin, wmax, wtotal;
+
+    *contentions = 0;
+    *wait_us = 0;
+    if (!f)
+        return -1;
+    while (fgets(line, sizeof(line), f)) {
+        name = strstr(line, "mmap_lock");
+        if (!name || !(p = strchr(name, ':')))
+            continue;
+        if (sscanf(p + 1, "%llu %llu %lf %lf %lf", &bounces, &cont, &wmin, &wmax, &wtotal) == 5) {
+            *contentions += cont;
+            *wait_us += wtotal;
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+/* Reserva size bytes con el modo dado; retorna NULL si falla */
+static char *region_alloc(enum mode mode, size_t size)
+{
+    long addr;
+    void *p;
+
+    switch (mode) {
+    case MODE_TAMALLOC:
+        addr = syscall(__NR__202000173_tamalloc_stats, size);
+        return addr < 0 ? NULL : (char *)addr;
+    case MODE_MMAP:
+        p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        return p == MAP_FAILED ? NULL : p;
+    case MODE_CALLOC:
+        return calloc(1, size);
+    default:
+        return NULL;
+    }
+}
+
+static void region_free(enum mode mode, char *p, size_t size)
+{
+    if (mode == MODE_CALLOC)
+        free(p);
+    else
+        munmap(p, size);
+}
+
+struct fault_result {
+    uint64_t wall_ns;
+    uint64_t thread_ns;
+    uint64_t alloc_ns;
+    uint64_t touches;
+    uint64_t faults;
+    uint64_t lock_contentions;
+    double lock_wait_us;
+    int lock_stat;
+};
+
+static int run_once(enum mode mode, struct fault_thread *threads, struct fault_result *res)
+{
+    size_t n = opt_threads, size = opt_pattern == PATTERN_PRIVATE ? opt_region : opt_region * n;
+    int regions = opt_pattern == PATTERN_PRIVATE ? opt_threads : 1;
+    char **mem = calloc(regions, sizeof(*mem));
+    uint64_t start, cont_before, cont_after;
+    double wait_before, wait_after;
+    int i, ok = -1;
+
+    if (!mem)
+        return -1;
+    memset(res, 0, sizeof(*res));
+
+    start = now_ns();
+    for (i = 0; i < regions; i++) {
+        mem[i] = region_alloc(mode, size);
+        if (!mem[i]) {
+            fprintf(stderr, "%s: no se pudo reservar %zu bytes: %s\n",
+                    mode_names[mode], size, strerror(errno));
+            goto out;
+        }
+    }
+    res->alloc_ns = now_ns() - start;
+
+    for (i = 0; i < opt_threads; i++) {
+        struct fault_thread *t = &threads[i];
+
+        t->index = i;
+        switch (opt_pattern) {
+        case PATTERN_PRIVATE:
+            t->base = mem[i];
+            t->first = 0;
+            t->end = opt_region;
+            t->step = opt_stride;
+            break;
+        case PATTERN_SPLIT:
+            t->base = mem[0];
+            t->first = i * opt_region;
+            t->end = (i + 1) * opt_region;
+            t->step = opt_stride;
+            break;
+        case PATTERN_INTERLEAVE:
+            t->base = mem[0];
+            t->first = i * opt_stride;
+            t->end = size;
+            t->step = opt_stride * n;
+            break;
+        }
+    }
+
+    res->lock_stat = read_mmap_lock_stat(&cont_before, &wait_before) == 0;
+    pthread_barrier_init(&start_barrier, NULL, opt_threads + 1);
+    for (i = 0; i < opt_threads; i++)
+        pthread_create(&threads[i].thread, NULL, fault_thread_fn, &threads[i]);
+    start = now_ns();
+    pthread_barrier_wait(&start_barrier);
+    for (i = 0; i < opt_threads; i++) {
+        pthread_join(threads[i].thread, NULL);
+        res->thread_ns += threads[i].elapsed_ns;
+        res->touches += threads[i].touches;
+        res->faults += threads[i].minflt;
+    }
+    res->wall_ns = now_ns() - start;
+    pthread_barrier_destroy(&start_barrier);
+    if (res->lock_stat && read_mmap_lock_stat(&cont_after, &wait_after) == 0) {
+        res->lock_contentions = cont_after - cont_before;
+        res->lock_wait_us = wait_after - wait_before;
+    }
+    ok = 0;
+out:
+    for (i = 0; i < regions; i++) {
+        if (mem[i])
+            region_free(mode, mem[i], size);
+    }
+    free(mem);
+    return ok;
+}
+
+static void print_header(void)
+{
+    if (!strcmp(opt_format, "csv"))
+        printf("mode,pattern,threads,region_bytes,stride,rep,faults,touches,faults_per_sec,"
+               "ns_per_fault,ns_per_touch,alloc_ns,wall_ns,mmap_lock_contentions,mmap_lock_wait_us\n");
+    else if (!strcmp(opt_format, "text"))
+        printf("%-9s %-10s %3s %10s %12s %9s %9s %10s %12s %12s\n", "modo", "patrón", "rep",
+               "fallos", "fallos/s", "ns/fallo", "ns/toque", "reserva_us", "contenciones", "espera_us");
+}
+
+static void print_result(enum mode mode, int rep, const struct fault_result *r)
+{
+    double fps = r->wall_ns ? r->faults * 1e9 / r->wall_ns : 0;
+    double ns_fault = r->faults ? (double)r->thread_ns / r->faults : 0;
+    double ns_touch = r->touches ? (double)r->thread_ns / r->touches : 0;
+
+    if (!strcmp(opt_format, "json")) {
+        printf("{\"mode\":\"%s\",\"pattern\":\"%s\",\"threads\":%d,\"region_bytes\":%zu,\"stride\":%zu,"
+               "\"rep\":%d,\"faults\":%llu,\"touches\":%llu,\"faults_per_sec\":%.0f,\"ns_per_fault\":%.1f,"
+               "\"ns_per_touch\":%.1f,\"alloc_ns\":%llu,\"wall_ns\":%llu",
+               mode_names[mode], pattern_names[opt_pattern], opt_threads, opt_region, opt_stride, rep,
+               (unsigned long long)r->faults, (unsigned long long)r->touches, fps, ns_fault, ns_touch,
+               (unsigned long long)r->alloc_ns, (unsigned long long)r->wall_ns);
+        if (r->lock_stat)
+            printf(",\"mmap_lock_contentions\":%llu,\"mmap_lock_wait_us\":%.2f}\n",
+                   (unsigned long long)r->lock_contentions, r->lock_wait_us);
+        else
+            printf(",\"mmap_lock_contentions\":null,\"mmap_lock_wait_us\":null}\n");
+    } else if (!strcmp(opt_format, "csv")) {
+        printf("%s,%s,%d,%zu,%zu,%d,%llu,%llu,%.0f,%.1f,%.1f,%llu,%llu,",
+               mode_names[mode], pattern_names[opt_pattern], opt_threads, opt_region, opt_stride, rep,
+               (unsigned long long)r->faults, (unsigned long long)r->touches, fps, ns_fault, ns_touch,
+               (unsigned long long)r->alloc_ns, (unsigned long long)r->wall_ns);
+        if (r->lock_stat)
+            printf("%llu,%.2f\n", (unsigned long long)r->lock_contentions, r->lock_wait_us);
+        else
+            printf(",\n");
+    } else {
+        printf("%-9s %-10s %3d %10llu %12.0f %9.1f %9.1f %10.1f ",
+               mode_names[mode], pattern_names[opt_pattern], rep, (unsigned long long)r->faults,
+               fps, ns_fault, ns_touch, r->alloc_ns / 1e3);
+        if (r->lock_stat)
+            printf("%12llu %12.2f\n", (unsigned long long)r->lock_contentions, r->lock_wait_us);
+        else
+            printf("%12s %12s\n", "n/d", "n/d");
+    }
+    fflush(stdout);
+}
+
+static int parse_modes(const char *list)
+{
+    char *copy = strdup(list), *tok, *save;
+    int m, found;
+
+    if (!copy)
+        return -1;
+    memset(opt_modes, 0, sizeof(opt_modes));
+    for (tok = strtok_r(copy, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        found = 0;
+        for (m = 0; m < NR_MODES; m++) {
+            if (!strcmp(tok, mode_names[m])) {
+                opt_modes[m] = 1;
+                found = 1;
+            }
+        }
+        if (!found) {
+            free(copy);
+            return -1;
+        }
+    }
+    free(copy);
+    return 0;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Uso: %s [opciones]\n"
+            "  -t N   hilos (%d)\n"
+            "  -s N   MB por hilo (%zu)\n"
+            "  -S N   bytes entre toques; por defecto el tamaño de página\n"
+            "  -p P   patrón: private, split o interleave (%s)\n"
+            "  -m L   modos separados por coma: tamalloc, mmap, calloc (todos)\n"
+            "  -r N   repeticiones por modo (%d)\n"
+            "  -f F   formato de salida: text, json o csv (%s)\n",
+            prog, opt_threads, opt_region >> 20, pattern_names[opt_pattern], opt_reps, opt_format);
+}
+
+int main(int argc, char *argv[])
+{
+    struct fault_thread *threads;
+    struct fault_result res;
+    int opt, m, rep, p;
+
+    opt_stride = sysconf(_SC_PAGESIZE);
+    while ((opt = getopt(argc, argv, "t:s:S:p:m:r:f:h")) != -1) {
+        switch (opt) {
+        case 't': opt_threads = atoi(optarg); break;
+        case 's': opt_region = (size_t)atol(optarg) << 20; break;
+        case 'S': opt_stride = (size_t)atol(optarg); break;
+        case 'p':
+            for (p = 0; p < 3 && strcmp(optarg, pattern_names[p]); p++)
+                ;
+            if (p == 3) {
+                usage(argv[0]);
+                return 1;
+            }
+            opt_pattern = p;
+            break;
+        case 'm':
+            if (parse_modes(optarg) < 0) {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'r': opt_reps = atoi(optarg); break;
+        case 'f': opt_format = optarg; break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (opt_threads <= 0 || !opt_region || !opt_stride || opt_reps <= 0 ||
+        (strcmp(opt_format, "text") && strcmp(opt_format, "json") && strcmp(opt_format, "csv"))) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    threads = calloc(opt_threads, sizeof(*threads));
+    if (!threads) {
+        perror("calloc");
+        return 1;
+    }
+
+    if (!strcmp(opt_format, "text") && access(LOCK_STAT_PATH, R_OK))
+        fprintf(stderr, "%s no disponible (CONFIG_LOCK_STAT): no se mide la contención de mmap_lock\n",
+                LOCK_STAT_PATH);
+
+    print_header();
+    for (m = 0; m < NR_MODES; m++) {
+        if (!opt_modes[m])
+            continue;
+        for (rep = 0; rep < opt_reps; rep++) {
+            if (run_once(m, threads, &res) < 0)
+                break;
+            print_result(m, rep, &res);
+        }
+    }
+
+    free(threads);
+    return 0;
+}
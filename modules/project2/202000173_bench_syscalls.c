@@ -0,0 +1,640 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <signal.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <sys/wait.h>
+
+#include "../202000173_bench_util.h"
+
+/*
+ * Microbenchmark de las syscalls 548-552 (project1 y project2) y 557-560
+ * (registro de límites de project3).
+ *
+ * Cada syscall se llama en un ciclo cerrado desde uno o varios hilos, cada
+ * uno fijado a un CPU, y se mide cada llamada por separado. Se reporta el
+ * throughput total y la latencia (mínimo, media, p50, p99, p999 y máximo) a
+ * partir de un histograma log-lineal con error menor a 3%. El throughput sale
+ * del mismo tiempo medido que la latencia (llamadas / (suma / hilos)), así
+ * que no incluye la preparación ni la limpieza fuera de la medición.
+ *
+ * El costo de varias syscalls depende del estado del sistema, así que se
+ * puede variar:
+ *   - -T N: procesos extra dormidos (550 recorre todos los procesos).
+ *   - -L N: procesos registrados en el registro de límites (558 copia la
+ *           lista completa). Requiere root.
+ *   - -t N: hilos concurrentes llamando la misma syscall.
+ *
+ * Con -f json o csv la salida es una línea por syscall, para comparar
+ * resultados entre builds del kernel (por ejemplo, en QEMU) con un script.
+ *
+ * Compilar: gcc -O2 -pthread -o bench_syscalls 202000173_bench_syscalls.c
+ * Uso:      ./bench_syscalls [-i iteraciones] [-w calentamiento] [-t hilos] [-c cpu]
+ *                            [-T procesos] [-L limites] [-s 548,551,...] [-f text|json|csv]
+ * Ejemplo:  sudo ./bench_syscalls -i 200000 -t 4 -T 10000 -L 1000 -f json
+ */
+
+#define NR_CAPTURE_MEMORY_SNAPSHOT     548
+#define NR_GET_IO_THROTTLE             549
+#define NR_TAMALLOC                    550
+#define NR_MEMORY_ALLOCATION_STATS     551
+#define NR_TAMALLOC_STATS              552
+#define NR_ADD_MEMORY_LIMIT            557
+#define NR_GET_MEMORY_LIMITS           558
+#define NR_UPDATE_MEMORY_LIMIT         559
+#define NR_REMOVE_MEMORY_LIMIT         560
+
+#define BENCH_LIMIT_BYTES  (1UL << 30)
+#define TAMALLOC_SIZE      (1UL << 20)
+
+/* Mismas definiciones que en el kernel */
+struct memory_snapshot {
+    unsigned long total_ram;
+    unsigned long free_ram;
+    unsigned long swap_total;
+    unsigned long swap_free;
+    unsigned long cache_ram;
+    unsigned long buffer_ram;
+    unsigned long active_ram;
+    unsigned long inactive_ram;
+};
+
+struct io_stats_user {
+    unsigned long long rchar;
+    unsigned long long wchar;
+    unsigned long long syscr;
+    unsigned long long syscw;
+    unsigned long long read_bytes;
+    unsigned long long write_bytes;
+};
+
+struct tamalloc_global_info {
+    unsigned long aggregate_vm_mb;
+    unsigned long aggregate_rss_mb;
+};
+
+struct tamalloc_proc_info {
+    unsigned long vm_kb;
+    unsigned long rss_kb;
+    unsigned int  rss_percent_of_vm;
+    int           oom_adjustment;
+};
+
+struct memory_limitation {
+    pid_t  pid;
+    size_t memory_limit;
+};
+
+struct bench_case;
+
+/* Estado de cada hilo */
+struct bench_thread {
+    pthread_t thread;
+    int cpu;
+    pid_t self;
+    pid_t target;                    /* Proceso propio para 557, 559 y 560 */
+    struct memory_limitation *limits; /* Buffer para 558 */
+    size_t limits_cap;
+    long toggle;
+    long iterations;
+    long warmup;
+    uint64_t errors;
+    int first_errno;
+    const struct bench_case *bc;
+    struct histogram hist;
+};
+
+/*
+ * Cada caso hace una llamada y retorna cuánto tardó solo la syscall medida;
+ * la preparación y limpieza que necesite (munmap, quitar el límite recién
+ * agregado, ...) quedan fuera de la medición. En *ret queda el resultado.
+ */
+struct bench_case {
+    const char *name;
+    int nr;
+    int needs_root;
+    uint64_t (*run_once)(struct bench_thread *t, long *ret);
+    int (*prepare)(struct bench_thread *t);
+    void (*cleanup)(struct bench_thread *t);
+};
+
+static uint64_t run_capture_memory_snapshot(struct bench_thread *t, long *ret)
+{
+    struct memory_snapshot snap;
+    uint64_t start = now_ns();
+
+    (void)t;
+    *ret = syscall(NR_CAPTURE_MEMORY_SNAPSHOT, &snap);
+    return now_ns() - start;
+}
+
+static uint64_t run_get_io_throttle(struct bench_thread *t, long *ret)
+{
+    struct io_stats_user stats;
+    uint64_t start = now_ns();
+
+    *ret = syscall(NR_GET_IO_THROTTLE, t->self, &stats);
+    return now_ns() - start;
+}
+
+static uint64_t run_tamalloc(struct bench_thread *t, long *ret)
+{
+    struct tamalloc_global_info info;
+    uint64_t start = now_ns();
+
+    (void)t;
+    *ret = syscall(NR_TAMALLOC, &info);
+    return now_ns() - start;
+}
+
+static uint64_t run_memory_allocation_statistics(struct bench_thread *t, long *ret)
+{
+    struct tamalloc_proc_info info;
+    uint64_t start = now_ns();
+
+    *ret = syscall(NR_MEMORY_ALLOCATION_STATS, t->self, &info);
+    return now_ns() - start;
+}
+
+static uint64_t run_tamalloc_stats(struct bench_thread *t, long *ret)
+{
+    uint64_t start = now_ns(), elapsed;
+
+    (void)t;
+    *ret = syscall(NR_TAMALLOC_STATS, TAMALLOC_SIZE);
+    elapsed = now_ns() - start;
+    if (*ret > 0)
+        munmap((void *)*ret, TAMALLOC_SIZE);
+    return elapsed;
+}
+
+static uint64_t run_add_memory_limit(struct bench_thread *t, long *ret)
+{
+    uint64_t start = now_ns(), elapsed;
+
+    *ret = syscall(NR_ADD_MEMORY_LIMIT, t->target, BENCH_LIMIT_BYTES);
+    elapsed = now_ns() - start;
+    if (*ret == 0)
+        syscall(NR_REMOVE_MEMORY_LIMIT, t->target);
+    return elapsed;
+}
+
+static uint64_t run_get_memory_limits(struct bench_thread *t, long *ret)
+{
+    uint64_t start = now_ns();
+    int returned;
+
+    *ret = syscall(NR_GET_MEMORY_LIMITS, t->limits, t->limits_cap, &returned);
+    return now_ns() - start;
+}
+
+static uint64_t run_update_memory_limit(struct bench_thread *t, long *ret)
+{
+    uint64_t start = now_ns();
+
+    // Se alterna entre dos valores para que cada llamada cambie el límite
+    *ret = syscall(NR_UPDATE_MEMORY_LIMIT, t->target, BENCH_LIMIT_BYTES + (t->toggle++ & 1) * 4096);
+    return now_ns() - start;
+}
+
+static uint64_t run_remove_memory_limit(struct bench_thread *t, long *ret)
+{
+    uint64_t start;
+
+    if (syscall(NR_ADD_MEMORY_LIMIT, t->target, BENCH_LIMIT_BYTES) != 0) {
+        *ret = -1;
+        return 0;
+    }
+    start = now_ns();
+    *ret = syscall(NR_REMOVE_MEMORY_LIMIT, t->target);
+    return now_ns() - start;
+}
+
+static int prepare_registered_target(struct bench_thread *t)
+{
+    return syscall(NR_ADD_MEMORY_LIMIT, t->target, BENCH_LIMIT_BYTES) == 0 ? 0 : -errno;
+}
+
+static void cleanup_registered_target(struct bench_thread *t)
+{
+    syscall(NR_REMOVE_MEMORY_LIMIT, t->target);
+}
+
+static const struct bench_case cases[] = {
+    {
+        .name       = "capture_memory_snapshot",
+        .nr         = NR_CAPTURE_MEMORY_SNAPSHOT,
+        .run_once   = run_capture_memory_snapshot,
+    },
+    {
+        .name       = "get_io_throttle",
+        .nr         = NR_GET_IO_THROTTLE,
+        .run_once   = run_get_io_throttle,
+    },
+    {
+        .name       = "tamalloc",
+        .nr         = NR_TAMALLOC,
+        .run_once   = run_tamalloc,
+    },
+    {
+        .name       = "memory_allocation_statistics",
+        .nr         = NR_MEMORY_ALLOCATION_STATS,
+        .run_once   = run_memory_allocation_statistics,
+    },
+    {
+        .name       = "tamalloc_stats",
+        .nr         = NR_TAMALLOC_STATS,
+        .run_once   = run_tamalloc_stats,
+    },
+    {
+        .name       = "add_memory_limit",
+        .nr         = NR_ADD_MEMORY_LIMIT,
+        .needs_root = 1,
+        .run_once   = run_add_memory_limit,
+    },
+    {
+        .name       = "get_memory_limits",
+        .nr         = NR_GET_MEMORY_LIMITS,
+        .run_once   = run_get_memory_limits,
+    },
+    {
+        .name       = "update_memory_limit",
+        .nr         = NR_UPDATE_MEMORY_LIMIT,
+        .needs_root = 1,
+        .run_once   = run_update_memory_limit,
+        .prepare    = prepare_registered_target,
+        .cleanup    = cleanup_registered_target,
+    },
+    {
+        .name       = "remove_memory_limit",
+        .nr         = NR_REMOVE_MEMORY_LIMIT,
+        .needs_root = 1,
+        .run_once   = run_remove_memory_limit,
+    },
+};
+
+#define NR_CASES (sizeof(cases) / sizeof(cases[0]))
+
+/* Configuración global */
+static long opt_iterations = 100000;
+static long opt_warmup = 1000;
+static int opt_threads = 1;
+static int opt_cpu = 0;
+static long opt_tasks = 0;
+static long opt_limits = 0;
+static const char *opt_format = "text";
+static int selected[NR_CASES];
+
+static pthread_barrier_t start_barrier;
+
+/* Procesos extra: los primeros opt_limits se registran, luego uno por hilo como target */
+static pid_t *spawned;
+static long nr_spawned;
+
+static void *bench_thread_fn(void *arg)
+{
+    struct bench_thread *t = arg;
+    uint64_t elapsed;
+    cpu_set_t set;
+    long i, ret;
+
+    CPU_ZERO(&set);
+    CPU_SET(t->cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+
+    for (i = 0; i < t->warmup; i++)
+        t->bc->run_once(t, &ret);
+
+    pthread_barrier_wait(&start_barrier);
+    for (i = 0; i < t->iterations; i++) {
+        elapsed = t->bc->run_once(t, &ret);
+        if (ret < 0) {
+            if (!t->errors)
+                t->first_errno = errno;
+            t->errors++;
+            continue;
+        }
+        hist_add(&t->hist, elapsed);
+    }
+    return NULL;
+}
+
+/* Tareas totales del sistema según /proc/loadavg (campo "ejecutando/total") */
+static void spawn_population(long n)
+{
+    pid_t parent = getpid(), pid;
+
+    spawned = calloc(n, sizeof(*spawned));
+    if (!spawned)
+        return;
+    for (nr_spawned = 0; nr_spawned < n; nr_spawned++) {
+        pid = fork();
+        if (pid < 0) {
+            fprintf(stderr, "fork: %s (se crearon %ld de %ld procesos)\n",
+                    strerror(errno), nr_spawned, n);
+            break;
+        }
+        if (pid == 0) {
+            prctl(PR_SET_PDEATHSIG, SIGKILL);
+            if (getppid() != parent)
+                _exit(0);
+            for (;;)
+                pause();
+        }
+        spawned[nr_spawned] = pid;
+    }
+}
+
+static void kill_population(void)
+{
+    long i;
+
+    for (i = 0; i < nr_spawned; i++)
+        kill(spawned[i], SIGKILL);
+    for (i = 0; i < nr_spawned; i++)
+        waitpid(spawned[i], NULL, 0);
+    free(spawned);
+}
+
+static void register_limits(long n)
+{
+    long i, ok = 0;
+
+    for (i = 0; i < n && i < nr_spawned; i++) {
+        if (syscall(NR_ADD_MEMORY_LIMIT, spawned[i], BENCH_LIMIT_BYTES) == 0)
+            ok++;
+    }
+    if (ok < n)
+        fprintf(stderr, "Solo se registraron %ld de %ld límites\n", ok, n);
+    opt_limits = ok;
+}
+
+static void unregister_limits(void)
+{
+    long i;
+
+    for (i = 0; i < opt_limits; i++)
+        syscall(NR_REMOVE_MEMORY_LIMIT, spawned[i]);
+}
+
+static void print_header(void)
+{
+    if (!strcmp(opt_format, "csv"))
+        printf("kernel,syscall,nr,status,cpu,threads,tasks,limits,iterations,errors,"
+               "ops_per_sec,min_ns,mean_ns,p50_ns,p99_ns,p999_ns,max_ns\n");
+    else if (!strcmp(opt_format, "text"))
+        printf("%-30s %4s %8s %12s %8s %8s %8s %8s %8s %8s\n", "syscall", "nr", "errores",
+               "ops/s", "min", "media", "p50", "p99", "p999", "max");
+}
+
+static void print_result(const struct bench_case *bc, const char *status, long tasks,
+                         const struct histogram *h, uint64_t errors, double ops)
+{
+    static struct utsname uts;
+    uint64_t mean = hist_mean(h);
+    uint64_t min = h->count ? h->min : 0;
+
+    if (!uts.release[0])
+        uname(&uts);
+
+    if (!strcmp(opt_format, "json")) {
+        printf("{\"kernel\":\"%s\",\"syscall\":\"%s\",\"nr\":%d,\"status\":\"%s\",\"cpu\":%d,"
+               "\"threads\":%d,\"tasks\":%ld,\"limits\":%ld,\"iterations\":%ld,\"errors\":%llu,"
+               "\"ops_per_sec\":%.0f,\"min_ns\":%llu,\"mean_ns\":%llu,\"p50_ns\":%llu,"
+               "\"p99_ns\":%llu,\"p999_ns\":%llu,\"max_ns\":%llu}\n",
+               uts.release, bc->name, bc->nr, status, opt_cpu, opt_threads, tasks, opt_limits,
+               opt_iterations, (unsigned long long)errors, ops, (unsigned long long)min,
+               (unsigned long long)mean,
+               (unsigned long long)hist_percentile(h, 0.50),
+               (unsigned long long)hist_percentile(h, 0.99),
+               (unsigned long long)hist_percentile(h, 0.999),
+               (unsigned long long)h->max);
+    } else if (!strcmp(opt_format, "csv")) {
+        printf("%s,%s,%d,%s,%d,%d,%ld,%ld,%ld,%llu,%.0f,%llu,%llu,%llu,%llu,%llu,%llu\n",
+               uts.release, bc->name, bc->nr, status, opt_cpu, opt_threads, tasks, opt_limits,
+               opt_iterations, (unsigned long long)errors, ops, (unsigned long long)min,
+               (unsigned long long)mean,
+               (unsigned long long)hist_percentile(h, 0.50),
+               (unsigned long long)hist_percentile(h, 0.99),
+               (unsigned long long)hist_percentile(h, 0.999),
+               (unsigned long long)h->max);
+    } else if (strcmp(status, "ok")) {
+        printf("%-30s %4d %s\n", bc->name, bc->nr, status);
+    } else {
+        printf("%-30s %4d %8llu %12.0f %8llu %8llu %8llu %8llu %8llu %8llu\n",
+               bc->name, bc->nr, (unsigned long long)errors, ops, (unsigned long long)min,
+               (unsigned long long)mean,
+               (unsigned long long)hist_percentile(h, 0.50),
+               (unsigned long long)hist_percentile(h, 0.99),
+               (unsigned long long)hist_percentile(h, 0.999),
+               (unsigned long long)h->max);
+    }
+    fflush(stdout);
+}
+
+static void run_case(const struct bench_case *bc, struct bench_thread *threads, long tasks)
+{
+    struct histogram *total = malloc(sizeof(*total));
+    uint64_t errors = 0;
+    const char *status = "ok";
+    int i, prepared = 0, first_errno = 0;
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (!total)
+        return;
+    hist_init(total);
+
+    if (bc->needs_root && geteuid() != 0) {
+        print_result(bc, "requiere_root", tasks, total, 0, 0);
+        free(total);
+        return;
+    }
+
+    for (i = 0; i < opt_threads; i++) {
+        struct bench_thread *t = &threads[i];
+
+        hist_init(&t->hist);
+        t->bc = bc;
+        t->cpu = (opt_cpu + i) % ncpu;
+        t->self = getpid();
+        t->iterations = opt_iterations;
+        t->warmup = opt_warmup;
+        t->errors = 0;
+        t->first_errno = 0;
+        t->toggle = 0;
+        if (bc->prepare && bc->prepare(t) < 0)
+            break;
+        prepared++;
+    }
+    if (prepared < opt_threads) {
+        status = "error_preparacion";
+        goto out;
+    }
+
+    pthread_barrier_init(&start_barrier, NULL, opt_threads);
+    for (i = 0; i < opt_threads; i++)
+        pthread_create(&threads[i].thread, NULL, bench_thread_fn, &threads[i]);
+    for (i = 0; i < opt_threads; i++) {
+        pthread_join(threads[i].thread, NULL);
+        hist_merge(total, &threads[i].hist);
+        errors += threads[i].errors;
+        if (!first_errno)
+            first_errno = threads[i].first_errno;
+    }
+    pthread_barrier_destroy(&start_barrier);
+
+    if (!total->count && first_errno == ENOSYS)
+        status = "no_soportada";
+    else if (!total->count)
+        status = "error";
+out:
+    for (i = 0; i < prepared; i++) {
+        if (bc->cleanup)
+            bc->cleanup(&threads[i]);
+    }
+    print_result(bc, status, tasks, total, errors,
+                 total->sum ? (double)total->count * 1e9 * opt_threads / total->sum : 0);
+    if (!strcmp(status, "error") && first_errno)
+        fprintf(stderr, "%s: %s\n", bc->name, strerror(first_errno));
+    free(total);
+}
+
+static int select_cases(const char *list)
+{
+    char *copy = strdup(list), *tok, *save;
+    unsigned int i;
+    int nr, found;
+
+    if (!copy)
+        return -1;
+    for (tok = strtok_r(copy, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        nr = atoi(tok);
+        found = 0;
+        for (i = 0; i < NR_CASES; i++) {
+            if (cases[i].nr == nr || !strcmp(cases[i].name, tok)) {
+                selected[i] = 1;
+                found = 1;
+            }
+        }
+        if (!found) {
+            fprintf(stderr, "Syscall desconocida: %s\n", tok);
+            free(copy);
+            return -1;
+        }
+    }
+    free(copy);
+    return 0;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Uso: %s [opciones]\n"
+            "  -i N   iteraciones medidas por hilo (%ld)\n"
+            "  -w N   iteraciones de calentamiento por hilo (%ld)\n"
+            "  -t N   hilos (%d)\n"
+            "  -c N   primer CPU; el hilo i se fija a c + i (%d)\n"
+            "  -T N   procesos extra dormidos durante la prueba (%ld)\n"
+            "  -L N   procesos registrados en el registro de límites, requiere root (%ld)\n"
+            "  -s L   syscalls a medir, por número o nombre separados por coma (todas)\n"
+            "  -f F   formato de salida: text, json o csv (%s)\n",
+            prog, opt_iterations, opt_warmup, opt_threads, opt_cpu, opt_tasks, opt_limits, opt_format);
+}
+
+int main(int argc, char *argv[])
+{
+    struct bench_thread *threads;
+    unsigned int i;
+    long tasks, extra;
+    int opt, any = 0;
+
+    while ((opt = getopt(argc, argv, "i:w:t:c:T:L:s:f:h")) != -1) {
+        switch (opt) {
+        case 'i': opt_iterations = atol(optarg); break;
+        case 'w': opt_warmup = atol(optarg); break;
+        case 't': opt_threads = atoi(optarg); break;
+        case 'c': opt_cpu = atoi(optarg); break;
+        case 'T': opt_tasks = atol(optarg); break;
+        case 'L': opt_limits = atol(optarg); break;
+        case 's':
+            if (select_cases(optarg) < 0)
+                return 1;
+            any = 1;
+            break;
+        case 'f': opt_format = optarg; break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (opt_iterations <= 0 || opt_warmup < 0 || opt_threads <= 0 || opt_cpu < 0 ||
+        opt_tasks < 0 || opt_limits < 0 ||
+        (strcmp(opt_format, "text") && strcmp(opt_format, "json") && strcmp(opt_format, "csv"))) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (!any) {
+        for (i = 0; i < NR_CASES; i++)
+            selected[i] = 1;
+    }
+    if (opt_limits && geteuid() != 0) {
+        fprintf(stderr, "-L requiere root; se usa un registro vacío\n");
+        opt_limits = 0;
+    }
+
+    threads = calloc(opt_threads, sizeof(*threads));
+    if (!threads) {
+        perror("calloc");
+        return 1;
+    }
+
+    /*
+     * Procesos extra: los del registro, uno por hilo como target de
+     * 557/559/560 (solo con root) y el resto hasta completar -T.
+     */
+    extra = opt_limits + (geteuid() == 0 ? opt_threads : 0);
+    spawn_population(opt_tasks > extra ? opt_tasks : extra);
+    if (nr_spawned < extra) {
+        fprintf(stderr, "No hay suficientes procesos para los límites y targets\n");
+        kill_population();
+        return 1;
+    }
+    register_limits(opt_limits);
+
+    for (i = 0; i < (unsigned int)opt_threads; i++) {
+        threads[i].target = geteuid() == 0 ? spawned[opt_limits + i] : 0;
+        threads[i].limits_cap = opt_limits + opt_threads + 16;
+        threads[i].limits = calloc(threads[i].limits_cap, sizeof(*threads[i].limits));
+        if (!threads[i].limits) {
+            perror("calloc");
+            unregister_limits();
+            kill_population();
+            return 1;
+        }
+    }
+
+    tasks = system_task_count();
+    print_header();
+    for (i = 0; i < NR_CASES; i++) {
+        if (selected[i])
+            run_case(&cases[i], threads, tasks);
+    }
+
+    unregister_limits();
+    kill_population();
+    for (i = 0; i < (unsigned int)opt_threads; i++)
+        free(threads[i].limits);
+    free(threads);
+    return 0;
+}
@@ -0,0 +1,469 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <sys/wait.h>
+
+#include "../202000173_bench_util.h"
+
+/*
+ * Generador de población sintética para medir cómo escalan las syscalls que
+ * agregan sobre todos los procesos o sobre todo el registro de límites.
+ *
+ * Crea procesos hasta cada tamaño de la lista -p (de forma incremental: el
+ * siguiente tamaño reutiliza los procesos ya creados). Cada proceso reserva
+ * -v MB de memoria virtual, toca -r MB de ella para que sea residente y crea
+ * -t hilos en total que quedan dormidos. Con -L k se registra uno de cada k
+ * procesos en el registro de límites (requiere root).
+ *
+ * Con -c R un proceso aparte hace R fork/exit por segundo mientras se mide,
+ * para ver el efecto de la lista de procesos cambiando bajo la syscall.
+ *
+ * En cada tamaño se llama -n veces a cada syscall de agregación y se imprime
+ * una línea por syscall: tareas del sistema, latencia (mínimo, p50, p99,
+ * máximo), ns por tarea y la tasa de churn que se logró.
+ *
+ * El proceso principal es de un solo hilo a propósito: hace todos los fork,
+ * así que los hijos pueden crear hilos sin heredar locks de otros hilos.
+ *
+ * Compilar: gcc -O2 -pthread -o gen_population 202000173_gen_population.c
+ * Uso:      ./gen_population [-p 100,1000,...] [-t hilos] [-v vm_mb] [-r rss_mb]
+ *                            [-c forks_por_s] [-L k] [-n llamadas] [-f text|json|csv]
+ * Ejemplo:  sudo ./gen_population -p 100,1000,10000,100000 -t 2 -v 64 -r 1 -c 500 -L 10
+ *
+ * Para 100k procesos normalmente hay que subir kernel.pid_max,
+ * kernel.threads-max y el límite de procesos del usuario (ulimit -u).
+ */
+
+#define NR_TAMALLOC                    550
+#define NR_GET_MEMORY_LIMITS           558
+#define NR_ADD_MEMORY_LIMIT            557
+#define NR_REMOVE_MEMORY_LIMIT         560
+#define NR_GET_MEMORY_LIMIT_STATS      565
+#define NR_GET_OOM_RANKING             573
+
+#define POP_LIMIT_BYTES  (1UL << 40)
+#define MAX_SIZES        32
+
+/* Mismas definiciones que en el kernel */
+struct tamalloc_global_info {
+    unsigned long aggregate_vm_mb;
+    unsigned long aggregate_rss_mb;
+};
+
+struct memory_limitation {
+    pid_t  pid;
+    size_t memory_limit;
+};
+
+struct memory_limitation_stats {
+    int32_t  pid;
+    int32_t  group_pid;
+    uint32_t flags;
+    uint32_t owner;
+    uint64_t memory_limit;
+    uint64_t group_usage;
+    uint64_t usage;
+    uint64_t reclaim_count;
+    uint64_t reclaimed_pages;
+    uint64_t reclaim_stall_ns;
+    uint64_t soft_limit;
+    uint32_t max_delay_ms;
+    uint32_t reserved;
+    uint64_t throttle_count;
+    uint64_t throttle_ns;
+};
+
+struct oom_rank_info {
+    int32_t  pid;
+    int32_t  oom_score_adj;
+    char     comm[16];
+    int64_t  points;
+    uint64_t oom_score;
+    uint64_t rss_pages;
+    uint64_t swap_pages;
+    uint64_t pgtable_pages;
+};
+
+/* Buffers de salida, dimensionados según la población más grande */
+static void *agg_buf;
+static size_t agg_cap;
+
+static long call_tamalloc(void)
+{
+    struct tamalloc_global_info info;
+
+    return syscall(NR_TAMALLOC, &info);
+}
+
+static long call_get_memory_limits(void)
+{
+    int returned;
+
+    return syscall(NR_GET_MEMORY_LIMITS, agg_buf, agg_cap, &returned);
+}
+
+static long call_get_memory_limit_stats(void)
+{
+    int returned;
+
+    return syscall(NR_GET_MEMORY_LIMIT_STATS, agg_buf, agg_cap, &returned);
+}
+
+static long call_get_oom_ranking(void)
+{
+    return syscall(NR_GET_OOM_RANKING, agg_buf, 16);
+}
+
+struct agg_case {
+    const char *name;
+    int nr;
+    long (*call)(void);
+};
+
+static const struct agg_case cases[] = {
+    { "tamalloc",                 NR_TAMALLOC,               call_tamalloc },
+    { "get_memory_limits",        NR_GET_MEMORY_LIMITS,      call_get_memory_limits },
+    { "get_memory_limit_stats",   NR_GET_MEMORY_LIMIT_STATS, call_get_memory_limit_stats },
+    { "get_oom_ranking",          NR_GET_OOM_RANKING,        call_get_oom_ranking },
+};
+
+#define NR_CASES (sizeof(cases) / sizeof(cases[0]))
+
+/* Configuración */
+static long sizes[MAX_SIZES];
+static int nr_sizes;
+static int opt_threads = 1;
+static long opt_vm_mb = 16;
+static long opt_rss_mb = 0;
+static long opt_churn = 0;
+static long opt_limit_every = 0;
+static long opt_calls = 200;
+static const char *opt_format = "text";
+
+static pid_t *population;
+static long nr_population;
+static long nr_limited;
+
+/* Contador compartido con el proceso de churn */
+static volatile uint64_t *churn_forks;
+static pid_t churn_pid;
+
+static void *member_thread_fn(void *arg)
+{
+    (void)arg;
+    for (;;)
+        pause();
+    return NULL;
+}
+
+/* Cuerpo de cada proceso de la población */
+static void member_main(pid_t parent)
+{
+    pthread_t thread;
+    char *region;
+    size_t vm = (size_t)opt_vm_mb << 20, rss = (size_t)opt_rss_mb << 20, off;
+    long page = sysconf(_SC_PAGESIZE);
+    int i;
+
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() != parent)
+        _exit(0);
+
+    if (vm) {
+        region = mmap(NULL, vm, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (region != MAP_FAILED) {
+            for (off = 0; off < rss && off < vm; off += page)
+                region[off] = 1;
+        }
+    }
+    for (i = 1; i < opt_threads; i++) {
+        if (pthread_create(&thread, NULL, member_thread_fn, NULL))
+            break;
+    }
+    for (;;)
+        pause();
+}
+
+/* Agrega procesos hasta llegar a target; retorna la población alcanzada */
+static long grow_population(long target)
+{
+    pid_t parent = getpid(), pid;
+
+    while (nr_population < target) {
+        pid = fork();
+        if (pid < 0) {
+            fprintf(stderr, "fork: %s (población de %ld, objetivo %ld)\n",
+                    strerror(errno), nr_population, target);
+            break;
+        }
+        if (pid == 0)
+            member_main(parent);
+        population[nr_population++] = pid;
+
+        if (opt_limit_every && (nr_population - 1) % opt_limit_every == 0 &&
+            syscall(NR_ADD_MEMORY_LIMIT, pid, POP_LIMIT_BYTES) == 0)
+            nr_limited++;
+    }
+    return nr_population;
+}
+
+static void kill_population(void)
+{
+    long i;
+
+    // Las entradas registradas con 557 no se eliminan solas cuando el proceso termina
+    for (i = 0; opt_limit_every && i < nr_population; i += opt_limit_every)
+        syscall(NR_REMOVE_MEMORY_LIMIT, population[i]);
+
+    for (i = 0; i < nr_population; i++)
+        kill(population[i], SIGKILL);
+    for (i = 0; i < nr_population; i++)
+        waitpid(population[i], NULL, 0);
+}
+
+/* Proceso aparte que hace opt_churn fork/exit por segundo, en lotes cada 10 ms */
+static void start_churn(void)
+{
+    struct timespec tick = { 0, 10 * 1000 * 1000 };
+    uint64_t next, credit = 0;
+    pid_t parent = getpid(), pid;
+
+    churn_forks = mmap(NULL, sizeof(*churn_forks), PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (churn_forks == MAP_FAILED) {
+        perror("mmap");
+        exit(1);
+    }
+    *churn_forks = 0;
+
+    churn_pid = fork();
+    if (churn_pid != 0)
+        return;
+
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() != parent)
+        _exit(0);
+    signal(SIGCHLD, SIG_IGN);  // Los hijos se recolectan solos
+    next = now_ns();
+    for (;;) {
+        nanosleep(&tick, NULL);
+        // credit acumula fork pendientes en milésimas para tasas bajas
+        credit += opt_churn * (now_ns() - next) / 1000000;
+        next = now_ns();
+        while (credit >= 1000) {
+            pid = fork();
+            if (pid == 0)
+                _exit(0);
+            if (pid > 0)
+                (*churn_forks)++;
+            credit -= 1000;
+        }
+    }
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+static void print_header(void)
+{
+    if (!strcmp(opt_format, "csv"))
+        printf("kernel,syscall,nr,status,population,tasks,threads,limited,churn_per_sec,"
+               "calls,min_ns,p50_ns,p99_ns,max_ns,ns_per_task\n");
+    else if (!strcmp(opt_format, "text"))
+        printf("%-24s %9s %9s %8s %8s %10s %10s %10s %10s %9s\n", "syscall", "población",
+               "tareas", "límites", "churn/s", "min", "p50", "p99", "max", "ns/tarea");
+}
+
+static void measure(const struct agg_case *ac, long tasks, uint64_t *lat)
+{
+    static struct utsname uts;
+    const char *status = "ok";
+    uint64_t start, forks, churn_start, min = 0, p50 = 0, p99 = 0, max = 0;
+    double churn_rate = 0, per_task = 0;
+    long i, ok = 0;
+    int err = 0;
+
+    if (!uts.release[0])
+        uname(&uts);
+
+    churn_start = now_ns();
+    forks = churn_forks ? *churn_forks : 0;
+    for (i = 0; i < opt_calls; i++) {
+        start = now_ns();
+        if (ac->call() < 0) {
+            err = errno;
+            continue;
+        }
+        lat[ok++] = now_ns() - start;
+    }
+    if (churn_forks)
+        churn_rate = (*churn_forks - forks) * 1e9 / (double)(now_ns() - churn_start);
+
+    if (ok) {
+        qsort(lat, ok, sizeof(*lat), cmp_u64);
+        min = lat[0];
+        p50 = lat[ok / 2];
+        p99 = lat[ok * 99 / 100];
+        max = lat[ok - 1];
+        per_task = tasks > 0 ? (double)p50 / tasks : 0;
+    } else {
+        status = err == ENOSYS ? "no_soportada" : "error";
+    }
+
+    if (!strcmp(opt_format, "json")) {
+        printf("{\"kernel\":\"%s\",\"syscall\":\"%s\",\"nr\":%d,\"status\":\"%s\",\"population\":%ld,"
+               "\"tasks\":%ld,\"threads\":%d,\"limited\":%ld,\"churn_per_sec\":%.0f,\"calls\":%ld,"
+               "\"min_ns\":%llu,\"p50_ns\":%llu,\"p99_ns\":%llu,\"max_ns\":%llu,\"ns_per_task\":%.2f}\n",
+               uts.release, ac->name, ac->nr, status, nr_population, tasks, opt_threads, nr_limited,
+               churn_rate, ok, (unsigned long long)min, (unsigned long long)p50,
+               (unsigned long long)p99, (unsigned long long)max, per_task);
+    } else if (!strcmp(opt_format, "csv")) {
+        printf("%s,%s,%d,%s,%ld,%ld,%d,%ld,%.0f,%ld,%llu,%llu,%llu,%llu,%.2f\n",
+               uts.release, ac->name, ac->nr, status, nr_population, tasks, opt_threads, nr_limited,
+               churn_rate, ok, (unsigned long long)min, (unsigned long long)p50,
+               (unsigned long long)p99, (unsigned long long)max, per_task);
+    } else if (!ok) {
+        printf("%-24s %9ld %9ld %8ld %s (%s)\n", ac->name, nr_population, tasks, nr_limited,
+               status, strerror(err));
+    } else {
+        printf("%-24s %9ld %9ld %8ld %8.0f %10llu %10llu %10llu %10llu %9.2f\n",
+               ac->name, nr_population, tasks, nr_limited, churn_rate,
+               (unsigned long long)min, (unsigned long long)p50,
+               (unsigned long long)p99, (unsigned long long)max, per_task);
+    }
+    fflush(stdout);
+}
+
+static int parse_sizes(const char *list)
+{
+    char *copy = strdup(list), *tok, *save;
+
+    if (!copy)
+        return -1;
+    nr_sizes = 0;
+    for (tok = strtok_r(copy, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        if (nr_sizes == MAX_SIZES || atol(tok) <= 0 ||
+            (nr_sizes && atol(tok) <= sizes[nr_sizes - 1])) {
+            free(copy);
+            return -1;
+        }
+        sizes[nr_sizes++] = atol(tok);
+    }
+    free(copy);
+    return nr_sizes ? 0 : -1;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Uso: %s [opciones]\n"
+            "  -p L   tamaños de población, crecientes y separados por coma (100,1000,10000)\n"
+            "  -t N   hilos por proceso (%d)\n"
+            "  -v N   MB de memoria virtual por proceso (%ld)\n"
+            "  -r N   MB residentes por proceso (%ld)\n"
+            "  -c N   fork/exit por segundo durante las mediciones (%ld)\n"
+            "  -L k   registra uno de cada k procesos en el registro de límites, requiere root\n"
+            "  -n N   llamadas por syscall en cada tamaño (%ld)\n"
+            "  -f F   formato de salida: text, json o csv (%s)\n",
+            prog, opt_threads, opt_vm_mb, opt_rss_mb, opt_churn, opt_calls, opt_format);
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t *lat;
+    long max_size, tasks;
+    unsigned int c;
+    int opt, i;
+
+    parse_sizes("100,1000,10000");
+    while ((opt = getopt(argc, argv, "p:t:v:r:c:L:n:f:h")) != -1) {
+        switch (opt) {
+        case 'p':
+            if (parse_sizes(optarg) < 0) {
+                fprintf(stderr, "Lista de tamaños inválida: %s\n", optarg);
+                return 1;
+            }
+            break;
+        case 't': opt_threads = atoi(optarg); break;
+        case 'v': opt_vm_mb = atol(optarg); break;
+        case 'r': opt_rss_mb = atol(optarg); break;
+        case 'c': opt_churn = atol(optarg); break;
+        case 'L': opt_limit_every = atol(optarg); break;
+        case 'n': opt_calls = atol(optarg); break;
+        case 'f': opt_format = optarg; break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (opt_threads <= 0 || opt_vm_mb < 0 || opt_rss_mb < 0 || opt_rss_mb > opt_vm_mb ||
+        opt_churn < 0 || opt_limit_every < 0 || opt_calls <= 0 ||
+        (strcmp(opt_format, "text") && strcmp(opt_format, "json") && strcmp(opt_format, "csv"))) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (opt_limit_every && geteuid() != 0) {
+        fprintf(stderr, "-L requiere root; no se registran límites\n");
+        opt_limit_every = 0;
+    }
+
+    max_size = sizes[nr_sizes - 1];
+    population = calloc(max_size, sizeof(*population));
+    lat = calloc(opt_calls, sizeof(*lat));
+    // El buffer más grande es el de 565: un registro por proceso limitado
+    agg_cap = opt_limit_every ? max_size / opt_limit_every + 16 : 16;
+    agg_buf = calloc(agg_cap, sizeof(struct memory_limitation_stats));
+    if (!population || !lat || !agg_buf) {
+        perror("calloc");
+        return 1;
+    }
+
+    if (opt_churn)
+        start_churn();
+
+    print_header();
+    for (i = 0; i < nr_sizes; i++) {
+        uint64_t start = now_ns();
+
+        if (grow_population(sizes[i]) < sizes[i] && nr_population == (i ? sizes[i - 1] : 0))
+            break;
+        if (!strcmp(opt_format, "text"))
+            fprintf(stderr, "Población de %ld procesos creada en %.2f s\n",
+                    nr_population, (now_ns() - start) / 1e9);
+
+        // Espera corta para que los hijos terminen de tocar su memoria y crear hilos
+        sleep(1);
+        tasks = system_task_count();
+        for (c = 0; c < NR_CASES; c++)
+            measure(&cases[c], tasks, lat);
+        if (nr_population < sizes[i])
+            break;
+    }
+
+    if (churn_pid > 0) {
+        kill(churn_pid, SIGKILL);
+        waitpid(churn_pid, NULL, 0);
+    }
+    kill_population();
+    free(population);
+    free(lat);
+    free(agg_buf);
+    return 0;
+}
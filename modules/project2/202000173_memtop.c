@@ -0,0 +1,578 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <poll.h>
+#include <getopt.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#include "../202000173_bench_util.h"
+
+/*
+ * Monitor de memoria en tiempo real, al estilo de top.
+ *
+ * Cada refresco hace una sola llamada a _202000173_get_memory_top (576), que
+ * retorna los agregados globales y los procesos que caben en pantalla, ya
+ * ordenados por RSS, memoria virtual o crecimiento. No se lee /proc ni se
+ * hace una syscall por proceso, así que el costo no crece con la cantidad de
+ * procesos en espacio de usuario.
+ *
+ * La pantalla se arma como un arreglo de líneas y solo se reescriben las que
+ * cambiaron respecto al refresco anterior. La línea "Costo propio" muestra la
+ * CPU que usa el monitor (usuario + sistema, incluida la syscall), el tiempo
+ * de la consulta y del dibujo, y cuántas filas se redibujaron.
+ *
+ * La columna de crecimiento necesita el rastreador de la syscall 574; -g lo
+ * arranca (requiere root) y queda activo al salir, porque otros consumidores
+ * pueden estar usándolo. Sin rastreador la columna muestra "-".
+ *
+ * Teclas: r (orden por RSS), v (memoria virtual), c (crecimiento),
+ *         + / - (intervalo de refresco), q (salir).
+ *
+ * Compilar: gcc -O2 -o memtop 202000173_memtop.c
+ * Uso:      ./memtop [-d ms] [-s rss|vm|growth] [-n filas] [-g ms_rastreador]
+ *                    [-b] [-i iteraciones]
+ * Ejemplo:  sudo ./memtop -d 500 -s growth -g 2000
+ *           ./memtop -b -n 10 -i 3        (modo por lotes, sin control de terminal)
+ */
+
+#define NR_GROWTH_TRACKER   574
+#define NR_GET_MEMORY_TOP   576
+
+#define MEMORY_TOP_MAX      1024
+#define MEMORY_TOP_SORT_RSS     0
+#define MEMORY_TOP_SORT_VM      1
+#define MEMORY_TOP_SORT_GROWTH  2
+#define MEMORY_TOP_HAS_GROWTH   0x1
+
+#define HEADER_ROWS   6
+#define MAX_COLS      512
+#define MIN_DELAY_MS  100
+#define MAX_DELAY_MS  10000
+
+/* Mismas definiciones que en el kernel */
+struct memory_top_global {
+    uint64_t timestamp_ns;
+    uint64_t total_ram;
+    uint64_t free_ram;
+    uint64_t available_ram;
+    uint64_t cache_ram;
+    uint64_t buffer_ram;
+    uint64_t shmem_ram;
+    uint64_t swap_total;
+    uint64_t swap_free;
+    uint64_t sum_rss;
+    uint64_t sum_vm;
+    uint64_t sum_swap;
+    uint32_t nr_processes;
+    uint32_t nr_threads;
+    uint32_t nr_running;
+    uint32_t nr_growing;
+    uint32_t growth_interval_ms;
+    uint32_t reserved;
+};
+
+struct memory_top_proc {
+    int32_t  pid;
+    uint32_t uid;
+    int32_t  oom_score_adj;
+    uint32_t flags;
+    char     comm[16];
+    uint64_t rss_bytes;
+    uint64_t vm_bytes;
+    uint64_t swap_bytes;
+    int64_t  rss_slope;
+    int64_t  vm_slope;
+};
+
+static const char *sort_names[] = { "RSS", "VM", "crecimiento" };
+
+/* Configuración */
+static int opt_delay_ms = 500;
+static unsigned int opt_sort = MEMORY_TOP_SORT_RSS;
+static int opt_rows;             /* 0: las que quepan en la terminal */
+static unsigned int opt_tracker_ms;
+static int opt_batch;
+static long opt_iterations;      /* 0: sin límite */
+
+/* Costo propio del último refresco */
+struct overhead {
+    uint64_t cpu_ns;     /* Usuario + sistema desde el refresco anterior */
+    uint64_t wall_ns;
+    uint64_t query_ns;
+    uint64_t render_ns;
+    unsigned int redrawn;
+    unsigned int rows;
+    size_t bytes;
+};
+
+/* Estado de la pantalla */
+static struct termios orig_termios;
+static int term_ready;
+static int term_rows = 24, term_cols = 80;
+static char (*prev_lines)[MAX_COLS];   /* Lo que hay en pantalla, una línea por fila */
+static unsigned int redrawn;
+static const char *status;             /* Aviso que reemplaza la línea de crecimiento */
+static volatile sig_atomic_t quit, resized;
+
+/* Buffer de salida: un solo write por refresco */
+static char *out;
+static size_t out_len, out_cap;
+
+static uint64_t cpu_ns(void)
+{
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000ULL +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000ULL;
+}
+
+static void out_append(const char *s, size_t len)
+{
+    if (out_len + len > out_cap) {
+        out_cap = (out_len + len) * 2;
+        out = realloc(out, out_cap);
+        if (!out) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    memcpy(out + out_len, s, len);
+    out_len += len;
+}
+
+static void out_printf(const char *fmt, ...)
+{
+    char buf[MAX_COLS + 64];
+    va_list ap;
+    int len;
+
+    va_start(ap, fmt);
+    len = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (len > 0)
+        out_append(buf, len < (int)sizeof(buf) ? (size_t)len : sizeof(buf) - 1);
+}
+
+static void out_flush(void)
+{
+    size_t done = 0;
+    ssize_t w;
+
+    while (done < out_len) {
+        w = write(STDOUT_FILENO, out + done, out_len - done);
+        if (w < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        done += w;
+    }
+    out_len = 0;
+}
+
+/* Tamaño legible: 512K, 12.3M, 1.5G */
+static const char *fmt_bytes(char *buf, size_t size, uint64_t bytes)
+{
+    static const char units[] = "KMGTP";
+    double v = bytes / 1024.0;
+    int u = 0;
+
+    while (v >= 1024 && u < 4) {
+        v /= 1024;
+        u++;
+    }
+    snprintf(buf, size, v < 10 && u ? "%.1f%c" : "%.0f%c", v, units[u]);
+    return buf;
+}
+
+static const char *fmt_rate(char *buf, size_t size, int64_t rate, int valid)
+{
+    char tmp[12];
+
+    if (!valid) {
+        snprintf(buf, size, "-");
+        return buf;
+    }
+    if (rate == 0) {
+        snprintf(buf, size, "0");
+        return buf;
+    }
+    fmt_bytes(tmp, sizeof(tmp), rate < 0 ? -(uint64_t)rate : (uint64_t)rate);
+    snprintf(buf, size, "%c%s/s", rate < 0 ? '-' : '+', tmp);
+    return buf;
+}
+
+static long get_memory_top(struct memory_top_global *global, struct memory_top_proc *buf,
+                           unsigned int n, unsigned int sort_by)
+{
+    return syscall(NR_GET_MEMORY_TOP, global, buf, n, sort_by);
+}
+
+static void restore_terminal(void)
+{
+    if (!term_ready)
+        return;
+    // Muestra el cursor y vuelve a la pantalla normal
+    out_len = 0;
+    out_printf("\033[?25h\033[?1049l");
+    out_flush();
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &orig_termios);
+    term_ready = 0;
+}
+
+static void on_signal(int sig)
+{
+    if (sig == SIGWINCH)
+        resized = 1;
+    else
+        quit = 1;
+}
+
+static void update_size(void)
+{
+    struct winsize ws;
+
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row && ws.ws_col) {
+        term_rows = ws.ws_row;
+        term_cols = ws.ws_col < MAX_COLS ? ws.ws_col : MAX_COLS - 1;
+    }
+}
+
+static void setup_terminal(void)
+{
+    struct termios raw;
+
+    if (tcgetattr(STDIN_FILENO, &orig_termios) < 0) {
+        perror("tcgetattr (use -b fuera de una terminal)");
+        exit(1);
+    }
+    raw = orig_termios;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+    term_ready = 1;
+    atexit(restore_terminal);
+
+    // Pantalla alternativa y cursor oculto
+    out_printf("\033[?1049h\033[?25l\033[2J");
+    out_flush();
+    update_size();
+}
+
+/* Cantidad de filas de procesos que se piden al kernel */
+static unsigned int table_rows(void)
+{
+    int rows = opt_rows;
+
+    if (!rows)
+        rows = opt_batch ? 20 : term_rows - HEADER_ROWS;
+    if (rows < 0)
+        rows = 0;
+    return rows > MEMORY_TOP_MAX ? MEMORY_TOP_MAX : rows;
+}
+
+/*
+ * Escribe la línea row de la pantalla si cambió. En modo por lotes se imprime
+ * todo sin secuencias de escape.
+ */
+static void put_line(int row, const char *attr, const char *fmt, ...)
+{
+    char line[MAX_COLS];
+    va_list ap;
+    int len;
+
+    va_start(ap, fmt);
+    len = vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    if (len < 0)
+        len = 0;
+    if (!opt_batch && len > term_cols)
+        line[term_cols] = '\0';
+
+    if (opt_batch) {
+        out_printf("%s\n", line);
+        return;
+    }
+    if (row >= term_rows || !strcmp(prev_lines[row], line))
+        return;
+    strcpy(prev_lines[row], line);
+    redrawn++;
+    out_printf("\033[%d;1H%s%s\033[K%s", row + 1, attr, line, *attr ? "\033[0m" : "");
+}
+
+static void render(const struct memory_top_global *g, const struct memory_top_proc *procs,
+                   long count, const struct overhead *cost)
+{
+    char a[16], b[16], c[16], d[16], e[16], f[16], h[16];
+    char clock[16];
+    time_t t = time(NULL);
+    int row = 0, screen_rows;
+    long i;
+
+    strftime(clock, sizeof(clock), "%H:%M:%S", localtime(&t));
+    screen_rows = opt_batch ? HEADER_ROWS + (int)count : term_rows;
+
+    put_line(row++, "\033[1m", "memtop  %s  cada %d ms  orden: %s  procesos %u  hilos %u  ejecutando %u",
+             clock, opt_delay_ms, sort_names[opt_sort], g->nr_processes, g->nr_threads,
+             g->nr_running);
+    put_line(row++, "", "RAM   total %-7s usada %-7s libre %-7s disponible %-7s caché %-7s buffers %-7s shmem %s",
+             fmt_bytes(a, sizeof(a), g->total_ram),
+             fmt_bytes(b, sizeof(b), g->total_ram - g->free_ram),
+             fmt_bytes(c, sizeof(c), g->free_ram),
+             fmt_bytes(d, sizeof(d), g->available_ram),
+             fmt_bytes(e, sizeof(e), g->cache_ram),
+             fmt_bytes(f, sizeof(f), g->buffer_ram),
+             fmt_bytes(h, sizeof(h), g->shmem_ram));
+    put_line(row++, "", "Swap  total %-7s usada %-7s libre %-7s | suma de procesos: RSS %s  VM %s  swap %s",
+             fmt_bytes(a, sizeof(a), g->swap_total),
+             fmt_bytes(b, sizeof(b), g->swap_total - g->swap_free),
+             fmt_bytes(c, sizeof(c), g->swap_free),
+             fmt_bytes(d, sizeof(d), g->sum_rss),
+             fmt_bytes(e, sizeof(e), g->sum_vm),
+             fmt_bytes(f, sizeof(f), g->sum_swap));
+    if (status)
+        put_line(row++, "\033[33m", "%s", status);
+    else if (g->growth_interval_ms)
+        put_line(row++, "", "Crecimiento: rastreador cada %u ms, %u procesos con RSS en aumento",
+                 g->growth_interval_ms, g->nr_growing);
+    else
+        put_line(row++, "", "Crecimiento: rastreador detenido (iniciarlo con -g ms, requiere root)");
+    put_line(row++, "", "Costo propio: CPU %.2f%%  consulta %.2f ms  dibujo %.2f ms  filas redibujadas %u/%u  %zu bytes",
+             cost->wall_ns ? 100.0 * cost->cpu_ns / cost->wall_ns : 0.0,
+             cost->query_ns / 1e6, cost->render_ns / 1e6, cost->redrawn, cost->rows, cost->bytes);
+    put_line(row++, "\033[7m", "%7s %6s %8s %8s %8s %10s %10s %5s %-16s",
+             "PID", "UID", "RSS", "VM", "SWAP", "RSS/s", "VM/s", "OOM", "COMANDO");
+
+    for (i = 0; i < count && row < screen_rows; i++) {
+        const struct memory_top_proc *p = &procs[i];
+        int growth = p->flags & MEMORY_TOP_HAS_GROWTH;
+
+        put_line(row++, "", "%7d %6u %8s %8s %8s %10s %10s %5d %-16.16s",
+                 p->pid, p->uid,
+                 fmt_bytes(a, sizeof(a), p->rss_bytes),
+                 fmt_bytes(b, sizeof(b), p->vm_bytes),
+                 fmt_bytes(c, sizeof(c), p->swap_bytes),
+                 fmt_rate(d, sizeof(d), p->rss_slope, growth),
+                 fmt_rate(e, sizeof(e), p->vm_slope, growth),
+                 p->oom_score_adj, p->comm);
+    }
+    // Filas que quedaron vacías porque hay menos procesos que antes
+    while (!opt_batch && row < screen_rows)
+        put_line(row++, "", "%s", "");
+}
+
+static void reset_screen(void)
+{
+    free(prev_lines);
+    prev_lines = calloc(term_rows, sizeof(*prev_lines));
+    if (!prev_lines) {
+        perror("calloc");
+        exit(1);
+    }
+    out_printf("\033[2J");
+}
+
+static void handle_key(char key, int *refresh)
+{
+    switch (key) {
+    case 'q':
+    case 'Q':
+        quit = 1;
+        break;
+    case 'r':
+        opt_sort = MEMORY_TOP_SORT_RSS;
+        status = NULL;
+        *refresh = 1;
+        break;
+    case 'v':
+        opt_sort = MEMORY_TOP_SORT_VM;
+        status = NULL;
+        *refresh = 1;
+        break;
+    case 'c':
+        opt_sort = MEMORY_TOP_SORT_GROWTH;
+        status = NULL;
+        *refresh = 1;
+        break;
+    case '+':
+        opt_delay_ms = opt_delay_ms * 2 > MAX_DELAY_MS ? MAX_DELAY_MS : opt_delay_ms * 2;
+        break;
+    case '-':
+        opt_delay_ms = opt_delay_ms / 2 < MIN_DELAY_MS ? MIN_DELAY_MS : opt_delay_ms / 2;
+        break;
+    }
+}
+
+static unsigned int parse_sort(const char *s)
+{
+    if (!strcmp(s, "rss"))
+        return MEMORY_TOP_SORT_RSS;
+    if (!strcmp(s, "vm"))
+        return MEMORY_TOP_SORT_VM;
+    if (!strcmp(s, "growth"))
+        return MEMORY_TOP_SORT_GROWTH;
+    return (unsigned int)-1;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Uso: %s [opciones]\n"
+            "  -d N   intervalo de refresco en ms (%d, mínimo %d)\n"
+            "  -s S   orden: rss, vm o growth (rss)\n"
+            "  -n N   filas de procesos (las que quepan; 20 en modo por lotes)\n"
+            "  -g N   arranca el rastreador de crecimiento con muestras cada N ms\n"
+            "  -b     modo por lotes: imprime cada refresco sin control de terminal\n"
+            "  -i N   cantidad de refrescos (sin límite)\n",
+            prog, opt_delay_ms, MIN_DELAY_MS);
+}
+
+int main(int argc, char *argv[])
+{
+    struct memory_top_global global;
+    struct memory_top_proc *procs;
+    struct overhead cost;
+    struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN };
+    uint64_t next_ns, start, last_wall, last_cpu, now;
+    long count, iterations = 0;
+    unsigned int n;
+    int opt, refresh, timeout;
+    char keys[16];
+    ssize_t nkeys, k;
+
+    while ((opt = getopt(argc, argv, "d:s:n:g:bi:h")) != -1) {
+        switch (opt) {
+        case 'd': opt_delay_ms = atoi(optarg); break;
+        case 's': opt_sort = parse_sort(optarg); break;
+        case 'n': opt_rows = atoi(optarg); break;
+        case 'g': opt_tracker_ms = (unsigned int)atoi(optarg); break;
+        case 'b': opt_batch = 1; break;
+        case 'i': opt_iterations = atol(optarg); break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (opt_delay_ms < MIN_DELAY_MS || opt_delay_ms > MAX_DELAY_MS || opt_sort > MEMORY_TOP_SORT_GROWTH ||
+        opt_rows < 0 || opt_iterations < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (opt_tracker_ms && syscall(NR_GROWTH_TRACKER, opt_tracker_ms) < 0) {
+        perror("_202000173_growth_tracker");
+        return 1;
+    }
+
+    // Verifica la syscall antes de tomar la terminal
+    if (get_memory_top(&global, NULL, 0, MEMORY_TOP_SORT_RSS) < 0) {
+        perror("_202000173_get_memory_top");
+        return 1;
+    }
+
+    procs = calloc(MEMORY_TOP_MAX, sizeof(*procs));
+    if (!procs) {
+        perror("calloc");
+        return 1;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    if (!opt_batch) {
+        signal(SIGWINCH, on_signal);
+        setup_terminal();
+        reset_screen();
+    }
+
+    memset(&cost, 0, sizeof(cost));
+    last_wall = now_ns();
+    last_cpu = cpu_ns();
+    next_ns = last_wall;
+    refresh = 1;
+    while (!quit) {
+        if (resized) {
+            resized = 0;
+            update_size();
+            reset_screen();
+            refresh = 1;
+        }
+
+        if (refresh || now_ns() >= next_ns) {
+            refresh = 0;
+            n = table_rows();
+
+            start = now_ns();
+            count = get_memory_top(&global, procs, n, opt_sort);
+            if (count < 0 && errno == ENODATA) {
+                // Orden por crecimiento sin rastreador: se vuelve a RSS
+                status = "Crecimiento: el rastreador está detenido; se ordena por RSS (iniciarlo con -g ms)";
+                opt_sort = MEMORY_TOP_SORT_RSS;
+                count = get_memory_top(&global, procs, n, opt_sort);
+            }
+            cost.query_ns = now_ns() - start;
+            if (count < 0) {
+                restore_terminal();
+                perror("_202000173_get_memory_top");
+                return 1;
+            }
+
+            start = now_ns();
+            redrawn = 0;
+            render(&global, procs, count, &cost);
+            if (!opt_batch) {
+                cost.redrawn = redrawn;
+                cost.rows = term_rows;
+            } else {
+                cost.redrawn = cost.rows = HEADER_ROWS + count;
+                out_append("\n", 1);
+            }
+            cost.bytes = out_len;
+            out_flush();
+            cost.render_ns = now_ns() - start;
+
+            // La CPU propia se mide entre refrescos, así incluye consulta, dibujo y espera
+            now = now_ns();
+            cost.wall_ns = now - last_wall;
+            cost.cpu_ns = cpu_ns() - last_cpu;
+            last_wall = now;
+            last_cpu = cpu_ns();
+
+            next_ns += (uint64_t)opt_delay_ms * 1000000ULL;
+            if (next_ns < now)
+                next_ns = now + (uint64_t)opt_delay_ms * 1000000ULL;
+
+            if (opt_iterations && ++iterations >= opt_iterations)
+                break;
+        }
+
+        now = now_ns();
+        timeout = next_ns > now ? (int)((next_ns - now + 999999) / 1000000) : 0;
+        if (opt_batch) {
+            poll(NULL, 0, timeout);
+            continue;
+        }
+        if (poll(&pfd, 1, timeout) > 0) {
+            nkeys = read(STDIN_FILENO, keys, sizeof(keys));
+            for (k = 0; k < nkeys; k++)
+                handle_key(keys[k], &refresh);
+        }
+    }
+
+    restore_terminal();
+    free(procs);
+    free(prev_lines);
+    free(out);
+    return 0;
+}
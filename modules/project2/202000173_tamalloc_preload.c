@@ -0,0 +1,432 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+/*
+ * Allocator para LD_PRELOAD que manda las reservas grandes a
+ * _202000173_tamalloc_stats (552) y deja las pequeñas en glibc.
+ *
+ * Sirve para probar el cero perezoso de tamalloc en aplicaciones reales sin
+ * cambiar su código: las páginas de una región nueva se ponen en cero en el
+ * primer fallo de página, así que calloc de una región recién creada no
+ * necesita memset.
+ *
+ * Cada región lleva un encabezado de TP_HEADER bytes al inicio de su primera
+ * página; free() reconoce las regiones propias por el desplazamiento dentro
+ * de la página y un magic que depende de la dirección. Las regiones
+ * liberadas se guardan por clase de tamaño (4 clases por potencia de 2, en
+ * páginas) para reutilizarlas sin llamar a 552 ni a munmap.
+ *
+ * Variables de entorno:
+ *   - TAMALLOC_THRESHOLD: bytes a partir de los cuales se usa tamalloc (131072).
+ *   - TAMALLOC_CACHE_MB:  memoria máxima guardada en el caché de regiones (64).
+ *   - TAMALLOC_STATS:     al terminar, imprime los contadores en stderr ("1")
+ *                         o los agrega a un archivo (ruta).
+ *
+ * Si la syscall no existe (ENOSYS) o falla (por ejemplo, por el límite de
+ * memoria de project3) la reserva se atiende con glibc.
+ *
+ * Compilar: gcc -O2 -shared -fPIC -o libtamalloc_preload.so 202000173_tamalloc_preload.c -ldl -pthread
+ * Uso:      TAMALLOC_STATS=1 LD_PRELOAD=./libtamalloc_preload.so <programa>
+ */
+
+#ifndef __NR__202000173_tamalloc_stats
+#define __NR__202000173_tamalloc_stats 552
+#endif
+
+#define TP_HEADER          64           /* También es la alineación de los punteros propios */
+#define TP_MAGIC           0x54414d414c4c4f43ULL
+#define TP_SUB_BITS        2
+#define TP_NR_CLASSES      (64 << TP_SUB_BITS)
+#define TP_CACHE_SLOTS     8
+#define TP_CACHE_MAX_MAP   (64UL << 20) /* Regiones más grandes no se guardan */
+
+/* Encabezado al inicio de cada región; ocupa TP_HEADER bytes */
+struct tp_header {
+    uint64_t magic;       /* TP_MAGIC ^ dirección del encabezado */
+    size_t   map_size;    /* Tamaño del mapeo (el de su clase) */
+    unsigned int size_class;
+    unsigned int reserved;
+    size_t   requested;
+};
+
+struct tp_class_cache {
+    volatile int lock;
+    unsigned int count;
+    struct tp_header *slots[TP_CACHE_SLOTS];
+};
+
+/* Contadores del proceso */
+struct tp_counters {
+    uint64_t large_allocs;        /* Reservas atendidas por este allocator */
+    uint64_t small_allocs;        /* Reservas que se mandaron a glibc */
+    uint64_t bytes_served;        /* Bytes pedidos en reservas grandes */
+    uint64_t tamalloc_calls;      /* Llamadas a la syscall 552 */
+    uint64_t tamalloc_failures;   /* Fallos de 552 atendidos por glibc */
+    uint64_t cache_hits;
+    uint64_t cache_misses;
+    uint64_t syscalls_saved;      /* 552 + munmap evitados por el caché */
+    uint64_t munmaps;
+    uint64_t zeroing_skipped;     /* calloc sobre regiones nuevas, sin memset */
+    uint64_t zeroing_bytes_saved;
+};
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void  __libc_free(void *ptr);
+
+static size_t tp_threshold = 128 * 1024;
+static size_t tp_cache_cap = 64UL << 20;
+static size_t tp_page_size = 4096;
+static int tp_disabled;           /* 552 no existe en este kernel */
+static size_t tp_cached_bytes;
+static struct tp_class_cache tp_cache[TP_NR_CLASSES];
+static struct tp_counters tp_stats;
+
+#define tp_count(field, v) __atomic_fetch_add(&tp_stats.field, (v), __ATOMIC_RELAXED)
+
+static void tp_lock(volatile int *lock)
+{
+    while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE))
+        while (__atomic_load_n(lock, __ATOMIC_RELAXED))
+            ;
+}
+
+static void tp_unlock(volatile int *lock)
+{
+    __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+
+/* Clase para n páginas: 4 clases por potencia de 2; *pages queda redondeado */
+static unsigned int tp_size_class(size_t *pages)
+{
+    size_t n = *pages, step;
+    unsigned int e, k;
+
+    if (n <= (1U << TP_SUB_BITS))
+        return n;
+    e = 63 - __builtin_clzll(n);
+    step = (size_t)1 << (e - TP_SUB_BITS);
+    k = (n - ((size_t)1 << e) + step - 1) / step;
+    *pages = ((size_t)1 << e) + k * step;
+    return (e << TP_SUB_BITS) + k + 1;
+}
+
+static struct tp_header *tp_header_of(void *ptr)
+{
+    struct tp_header *hdr;
+
+    if (!ptr || ((uintptr_t)ptr & (tp_page_size - 1)) != TP_HEADER)
+        return NULL;
+    // ptr - TP_HEADER está en la misma página que ptr, así que siempre se puede leer
+    hdr = (struct tp_header *)((char *)ptr - TP_HEADER);
+    return hdr->magic == (TP_MAGIC ^ (uintptr_t)hdr) ? hdr : NULL;
+}
+
+static struct tp_header *tp_cache_get(unsigned int cls)
+{
+    struct tp_class_cache *c = &tp_cache[cls];
+    struct tp_header *hdr = NULL;
+
+    tp_lock(&c->lock);
+    if (c->count)
+        hdr = c->slots[--c->count];
+    tp_unlock(&c->lock);
+    if (hdr)
+        __atomic_fetch_sub(&tp_cached_bytes, hdr->map_size, __ATOMIC_RELAXED);
+    return hdr;
+}
+
+static int tp_cache_put(struct tp_header *hdr)
+{
+    struct tp_class_cache *c = &tp_cache[hdr->size_class];
+    int ok = 0;
+
+    if (hdr->map_size > TP_CACHE_MAX_MAP)
+        return 0;
+    if (__atomic_add_fetch(&tp_cached_bytes, hdr->map_size, __ATOMIC_RELAXED) <= tp_cache_cap) {
+        tp_lock(&c->lock);
+        if (c->count < TP_CACHE_SLOTS) {
+            c->slots[c->count++] = hdr;
+            ok = 1;
+        }
+        tp_unlock(&c->lock);
+    }
+    if (!ok)
+        __atomic_fetch_sub(&tp_cached_bytes, hdr->map_size, __ATOMIC_RELAXED);
+    return ok;
+}
+
+/*
+ * Reserva grande. *fresh queda en 1 si la región viene directo de la
+ * syscall (todas sus páginas están en cero). Retorna NULL para que el
+ * llamador use glibc.
+ */
+static void *tp_alloc(size_t size, int *fresh)
+{
+    struct tp_header *hdr;
+    size_t pages;
+    unsigned int cls;
+    long addr;
+
+    if (size > SIZE_MAX - TP_HEADER - tp_page_size)
+        return NULL;
+    pages = (size + TP_HEADER + tp_page_size - 1) / tp_page_size;
+    cls = tp_size_class(&pages);
+
+    *fresh = 0;
+    hdr = cls < TP_NR_CLASSES ? tp_cache_get(cls) : NULL;
+    if (hdr) {
+        tp_count(cache_hits, 1);
+        tp_count(syscalls_saved, 2);
+    } else {
+        tp_count(cache_misses, 1);
+        tp_count(tamalloc_calls, 1);
+        addr = syscall(__NR__202000173_tamalloc_stats, pages * tp_page_size);
+        if (addr < 0) {
+            if (errno == ENOSYS)
+                tp_disabled = 1;
+            tp_count(tamalloc_failures, 1);
+            return NULL;
+        }
+        hdr = (struct tp_header *)addr;
+        hdr->magic = TP_MAGIC ^ (uintptr_t)hdr;
+        hdr->map_size = pages * tp_page_size;
+        hdr->size_class = cls;
+        *fresh = 1;
+    }
+    hdr->requested = size;
+    tp_count(large_allocs, 1);
+    tp_count(bytes_served, size);
+    return (char *)hdr + TP_HEADER;
+}
+
+static void tp_release(struct tp_header *hdr)
+{
+    if (hdr->size_class < TP_NR_CLASSES && tp_cache_put(hdr))
+        return;
+    tp_count(munmaps, 1);
+    munmap(hdr, hdr->map_size);
+}
+
+static int tp_use(size_t size)
+{
+    return size >= tp_threshold && !tp_disabled;
+}
+
+void *malloc(size_t size)
+{
+    void *p;
+    int fresh;
+
+    if (tp_use(size) && (p = tp_alloc(size, &fresh)))
+        return p;
+    tp_count(small_allocs, 1);
+    return __libc_malloc(size);
+}
+
+void free(void *ptr)
+{
+    struct tp_header *hdr = tp_header_of(ptr);
+
+    if (hdr)
+        tp_release(hdr);
+    else
+        __libc_free(ptr);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+    size_t total;
+    void *p;
+    int fresh;
+
+    if (__builtin_mul_overflow(nmemb, size, &total)) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    if (tp_use(total) && (p = tp_alloc(total, &fresh))) {
+        // Una región nueva de tamalloc ya está en cero (cero perezoso)
+        if (fresh) {
+            tp_count(zeroing_skipped, 1);
+            tp_count(zeroing_bytes_saved, total);
+        } else {
+            memset(p, 0, total);
+        }
+        return p;
+    }
+    tp_count(small_allocs, 1);
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    struct tp_header *hdr = tp_header_of(ptr);
+    size_t old;
+    void *p;
+
+    if (!hdr)
+        return __libc_realloc(ptr, size);
+    if (!size) {
+        tp_release(hdr);
+        return NULL;
+    }
+    // Si cabe en la región actual no hace falta mover nada
+    if (size <= hdr->map_size - TP_HEADER) {
+        hdr->requested = size;
+        return ptr;
+    }
+    p = malloc(size);
+    if (!p)
+        return NULL;
+    // Solo los datos del llamador: copiar la región completa tocaría páginas aún sin usar
+    old = hdr->requested;
+    memcpy(p, ptr, old < size ? old : size);
+    tp_release(hdr);
+    return p;
+}
+
+/* Los punteros propios están alineados a TP_HEADER; alineaciones mayores van a glibc */
+static void *tp_memalign(size_t alignment, size_t size)
+{
+    void *p;
+    int fresh;
+
+    if (alignment <= TP_HEADER && tp_use(size) && (p = tp_alloc(size, &fresh)))
+        return p;
+    tp_count(small_allocs, 1);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+    void *p;
+
+    if (!alignment || (alignment & (alignment - 1)) || alignment % sizeof(void *))
+        return EINVAL;
+    p = tp_memalign(alignment, size);
+    if (!p)
+        return ENOMEM;
+    *memptr = p;
+    return 0;
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+    return tp_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    return tp_memalign(alignment, size);
+}
+
+void *valloc(size_t size)
+{
+    return tp_memalign(tp_page_size, size);
+}
+
+size_t malloc_usable_size(void *ptr)
+{
+    static size_t (*libc_usable_size)(void *);
+    struct tp_header *hdr = tp_header_of(ptr);
+
+    if (hdr)
+        return hdr->map_size - TP_HEADER;
+    if (!libc_usable_size)
+        libc_usable_size = dlsym(RTLD_NEXT, "malloc_usable_size");
+    return libc_usable_size ? libc_usable_size(ptr) : 0;
+}
+
+/* fork con un lock de clase tomado por otro hilo dejaría al hijo bloqueado */
+static void tp_atfork_prepare(void)
+{
+    int i;
+
+    for (i = 0; i < TP_NR_CLASSES; i++)
+        tp_lock(&tp_cache[i].lock);
+}
+
+static void tp_atfork_release(void)
+{
+    int i;
+
+    for (i = TP_NR_CLASSES - 1; i >= 0; i--)
+        tp_unlock(&tp_cache[i].lock);
+}
+
+__attribute__((constructor))
+static void tp_init(void)
+{
+    const char *env;
+    long page = sysconf(_SC_PAGESIZE);
+
+    if (page > 0)
+        tp_page_size = page;
+    env = getenv("TAMALLOC_THRESHOLD");
+    if (env && strtoull(env, NULL, 0) > 0)
+        tp_threshold = strtoull(env, NULL, 0);
+    env = getenv("TAMALLOC_CACHE_MB");
+    if (env)
+        tp_cache_cap = strtoull(env, NULL, 0) << 20;
+    pthread_atfork(tp_atfork_prepare, tp_atfork_release, tp_atfork_release);
+}
+
+__attribute__((destructor))
+static void tp_report(void)
+{
+    const char *env = getenv("TAMALLOC_STATS");
+    char line[512];
+    int fd, len;
+
+    if (!env || !*env)
+        return;
+
+    len = snprintf(line, sizeof(line),
+                   "tamalloc_preload pid=%d threshold=%zu large_allocs=%llu small_allocs=%llu "
+                   "bytes_served=%llu tamalloc_calls=%llu tamalloc_failures=%llu cache_hits=%llu "
+                   "cache_misses=%llu syscalls_saved=%llu munmaps=%llu zeroing_skipped=%llu "
+                   "zeroing_bytes_saved=%llu disabled=%d\n",
+                   getpid(), tp_threshold,
+                   (unsigned long long)tp_stats.large_allocs,
+                   (unsigned long long)tp_stats.small_allocs,
+                   (unsigned long long)tp_stats.bytes_served,
+                   (unsigned long long)tp_stats.tamalloc_calls,
+                   (unsigned long long)tp_stats.tamalloc_failures,
+                   (unsigned long long)tp_stats.cache_hits,
+                   (unsigned long long)tp_stats.cache_misses,
+                   (unsigned long long)tp_stats.syscalls_saved,
+                   (unsigned long long)tp_stats.munmaps,
+                   (unsigned long long)tp_stats.zeroing_skipped,
+                   (unsigned long long)tp_stats.zeroing_bytes_saved,
+                   tp_disabled);
+    if (len <= 0)
+        return;
+    if (len >= (int)sizeof(line))
+        len = sizeof(line) - 1;
+
+    // write() directo: en un destructor stdio puede estar cerrado
+    if (!strcmp(env, "1")) {
+        fd = STDERR_FILENO;
+    } else {
+        fd = open(env, O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0)
+            return;
+    }
+    if (write(fd, line, len) < 0) {
+        // Nada más que hacer si no se pudo escribir el reporte
+    }
+    if (fd != STDERR_FILENO)
+        close(fd);
+}
@@ -0,0 +1,557 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <time.h>
+#include <signal.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+#include "../202000173_bench_util.h"
+
+/*
+ * Prueba de estrés concurrente y benchmark de contención del registro de
+ * límites de memoria (syscalls 557-560).
+ *
+ * -t hilos llaman add/update/remove/get (557/559/560/558) sobre PIDs al azar
+ * de un conjunto de -p procesos dormidos creados por el programa, con la
+ * mezcla de operaciones de -m. Una fracción -x de las operaciones usa PIDs de
+ * procesos que ya terminaron, para ejercitar los caminos de error.
+ *
+ * Mientras tanto un hilo verificador lee la lista completa con 558 cada -i ms
+ * y comprueba que:
+ *   - el valor de retorno coincide con processes_returned;
+ *   - no hay PIDs repetidos;
+ *   - todo PID es del conjunto de prueba o ya estaba registrado al empezar;
+ *   - todo límite es uno de los valores que escriben los hilos.
+ *
+ * Al terminar, con el registro quieto, se comprueba además que:
+ *   - adds exitosos - removes exitosos == PIDs del conjunto en la lista;
+ *   - update (559, que busca en la tabla hash) tiene éxito exactamente para
+ *     los PIDs que aparecen en la lista (558);
+ *   - después de quitar todo, la lista vuelve a ser la del inicio.
+ *
+ * Se reporta ops/s por operación y total, y la latencia (p50, p99, máximo)
+ * de cada operación, para comparar esquemas de locking del registro.
+ * El programa termina con código 2 si encontró inconsistencias.
+ *
+ * Requiere root (CAP_SYS_ADMIN) para 557, 559 y 560.
+ *
+ * Compilar: gcc -O2 -pthread -o stress_limits 202000173_stress_limits.c
+ * Uso:      sudo ./stress_limits [-t hilos] [-p procesos] [-d segundos]
+ *                                [-m add:update:remove:get] [-x fracción_inválida]
+ *                                [-i ms_verificador] [-f text|json]
+ * Ejemplo:  sudo ./stress_limits -t 16 -p 512 -d 30 -m 30:30:30:10
+ */
+
+#define NR_ADD_MEMORY_LIMIT     557
+#define NR_GET_MEMORY_LIMITS    558
+#define NR_UPDATE_MEMORY_LIMIT  559
+#define NR_REMOVE_MEMORY_LIMIT  560
+
+/* Errores propios de 557 */
+#define ERR_OVER_LIMIT          100
+#define ERR_ALREADY_REGISTERED  101
+
+/* Los límites válidos son LIMIT_BASE + k * LIMIT_STEP, k < LIMIT_VALUES */
+#define LIMIT_BASE    (1UL << 40)
+#define LIMIT_STEP    4096UL
+#define LIMIT_VALUES  256
+
+/* Mismas definiciones que en el kernel */
+struct memory_limitation {
+    pid_t  pid;
+    size_t memory_limit;
+};
+
+enum op { OP_ADD, OP_UPDATE, OP_REMOVE, OP_GET, NR_OPS };
+static const char *op_names[] = { "add", "update", "remove", "get" };
+
+struct op_stats {
+    struct histogram hist; /* Latencia de cada llamada; hist.count es el total */
+    uint64_t ok;
+    uint64_t esrch;
+    uint64_t registered;   /* 557 con -101: ya estaba registrado */
+    uint64_t other;
+};
+
+struct worker {
+    pthread_t thread;
+    unsigned int seed;
+    struct memory_limitation *buf;
+    struct op_stats ops[NR_OPS];
+    uint64_t dead_pid_success;   /* Operaciones que tuvieron éxito sobre PIDs muertos */
+};
+
+/* Configuración */
+static int opt_threads = 8;
+static long opt_pool = 256;
+static int opt_seconds = 10;
+static unsigned int opt_mix[NR_OPS] = { 30, 30, 30, 10 };
+static double opt_invalid = 0.05;
+static int opt_check_ms = 50;
+static const char *opt_format = "text";
+
+static pid_t *pool;
+static pid_t *dead;
+static long nr_dead;
+static struct memory_limitation *baseline;
+static int nr_baseline;
+static size_t list_cap;
+static volatile int stop;
+
+/* Resultados del verificador */
+static uint64_t checks;
+static uint64_t violations;
+
+static void violation(const char *fmt, ...)
+{
+    va_list ap;
+
+    __atomic_fetch_add(&violations, 1, __ATOMIC_RELAXED);
+    va_start(ap, fmt);
+    fprintf(stderr, "INCONSISTENCIA: ");
+    vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+    va_end(ap);
+}
+
+static long get_limits(struct memory_limitation *buf, size_t cap, int *returned)
+{
+    *returned = -1;
+    return syscall(NR_GET_MEMORY_LIMITS, buf, cap, returned);
+}
+
+static int in_baseline(pid_t pid)
+{
+    int i;
+
+    for (i = 0; i < nr_baseline; i++) {
+        if (baseline[i].pid == pid)
+            return 1;
+    }
+    return 0;
+}
+
+static long pool_index(pid_t pid)
+{
+    long i;
+
+    for (i = 0; i < opt_pool; i++) {
+        if (pool[i] == pid)
+            return i;
+    }
+    return -1;
+}
+
+/* Comprueba una lectura de 558; seen (de opt_pool elementos) marca los PIDs del conjunto */
+static void check_snapshot(const struct memory_limitation *buf, long ret, int returned,
+                           unsigned char *seen)
+{
+    unsigned long k;
+    long i, idx;
+
+    if (ret < 0) {
+        violation("558 falló: %s", strerror(errno));
+        return;
+    }
+    if (ret != returned)
+        violation("558 retornó %ld pero processes_returned es %d", ret, returned);
+    if ((size_t)ret > list_cap)
+        violation("558 retornó %ld registros con capacidad %zu", ret, list_cap);
+
+    memset(seen, 0, opt_pool);
+    for (i = 0; i < ret && (size_t)i < list_cap; i++) {
+        if (in_baseline(buf[i].pid))
+            continue;
+        idx = pool_index(buf[i].pid);
+        if (idx < 0) {
+            violation("PID %d en la lista no es del conjunto de prueba (límite %zu)",
+                      buf[i].pid, buf[i].memory_limit);
+            continue;
+        }
+        if (seen[idx])
+            violation("PID %d aparece dos veces en la lista (límite %zu)", buf[i].pid, buf[i].memory_limit);
+        seen[idx] = 1;
+
+        k = (buf[i].memory_limit - LIMIT_BASE) / LIMIT_STEP;
+        if (buf[i].memory_limit < LIMIT_BASE || (buf[i].memory_limit - LIMIT_BASE) % LIMIT_STEP ||
+            k >= LIMIT_VALUES)
+            violation("PID %d tiene un límite que ningún hilo escribió: %zu", buf[i].pid, buf[i].memory_limit);
+    }
+}
+
+static void *checker_fn(void *arg)
+{
+    struct memory_limitation *buf = calloc(list_cap, sizeof(*buf));
+    unsigned char *seen = calloc(opt_pool, 1);
+    struct timespec interval = { opt_check_ms / 1000, (opt_check_ms % 1000) * 1000000L };
+    int returned;
+    long ret;
+
+    (void)arg;
+    if (!buf || !seen)
+        return NULL;
+    while (!stop) {
+        ret = get_limits(buf, list_cap, &returned);
+        check_snapshot(buf, ret, returned, seen);
+        checks++;
+        nanosleep(&interval, NULL);
+    }
+    free(buf);
+    free(seen);
+    return NULL;
+}
+
+static enum op pick_op(unsigned int *seed)
+{
+    unsigned int total = 0, r, i;
+
+    for (i = 0; i < NR_OPS; i++)
+        total += opt_mix[i];
+    r = rand_r(seed) % total;
+    for (i = 0; i < NR_OPS; i++) {
+        if (r < opt_mix[i])
+            return i;
+        r -= opt_mix[i];
+    }
+    return OP_GET;
+}
+
+static void *worker_fn(void *arg)
+{
+    struct worker *w = arg;
+    struct op_stats *s;
+    uint64_t start, elapsed;
+    size_t limit;
+    enum op op;
+    pid_t pid;
+    long ret;
+    int invalid, returned, err;
+
+    while (!stop) {
+        op = pick_op(&w->seed);
+        invalid = nr_dead && rand_r(&w->seed) < opt_invalid * ((double)RAND_MAX + 1);
+        pid = invalid ? dead[rand_r(&w->seed) % nr_dead] : pool[rand_r(&w->seed) % opt_pool];
+        limit = LIMIT_BASE + (rand_r(&w->seed) % LIMIT_VALUES) * LIMIT_STEP;
+
+        start = now_ns();
+        switch (op) {
+        case OP_ADD:
+            ret = syscall(NR_ADD_MEMORY_LIMIT, pid, limit);
+            break;
+        case OP_UPDATE:
+            ret = syscall(NR_UPDATE_MEMORY_LIMIT, pid, limit);
+            break;
+        case OP_REMOVE:
+            ret = syscall(NR_REMOVE_MEMORY_LIMIT, pid);
+            break;
+        default:
+            ret = get_limits(w->buf, list_cap, &returned);
+            break;
+        }
+        elapsed = now_ns() - start;
+        err = ret < 0 ? errno : 0;
+
+        s = &w->ops[op];
+        hist_add(&s->hist, elapsed);
+        if (!err)
+            s->ok++;
+        else if (err == ESRCH)
+            s->esrch++;
+        else if (err == ERR_ALREADY_REGISTERED)
+            s->registered++;
+        else
+            s->other++;
+
+        // Un PID muerto no puede registrarse ni encontrarse, salvo que se haya reutilizado
+        if (invalid && !err && op != OP_GET && kill(pid, 0) < 0)
+            w->dead_pid_success++;
+    }
+    return NULL;
+}
+
+static void spawn_pool(void)
+{
+    pid_t parent = getpid(), pid;
+    long i;
+
+    for (i = 0; i < opt_pool; i++) {
+        pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            exit(1);
+        }
+        if (pid == 0) {
+            prctl(PR_SET_PDEATHSIG, SIGKILL);
+            if (getppid() != parent)
+                _exit(0);
+            for (;;)
+                pause();
+        }
+        pool[i] = pid;
+    }
+
+    // PIDs de procesos que ya terminaron, para los caminos de error
+    for (nr_dead = 0; nr_dead < 64; nr_dead++) {
+        pid = fork();
+        if (pid < 0)
+            break;
+        if (pid == 0)
+            _exit(0);
+        waitpid(pid, NULL, 0);
+        dead[nr_dead] = pid;
+    }
+}
+
+static void kill_pool(void)
+{
+    long i;
+
+    for (i = 0; i < opt_pool; i++)
+        kill(pool[i], SIGKILL);
+    for (i = 0; i < opt_pool; i++)
+        waitpid(pool[i], NULL, 0);
+}
+
+/* Verificación final con el registro quieto; quita todos los registros del conjunto */
+static void final_check(const struct worker *workers)
+{
+    struct memory_limitation *buf = calloc(list_cap, sizeof(*buf));
+    unsigned char *seen = calloc(opt_pool, 1);
+    long adds = 0, removes = 0, listed = 0, ret, i;
+    int returned, t;
+
+    if (!buf || !seen) {
+        perror("calloc");
+        exit(1);
+    }
+    for (t = 0; t < opt_threads; t++) {
+        adds += workers[t].ops[OP_ADD].ok;
+        removes += workers[t].ops[OP_REMOVE].ok;
+        if (workers[t].dead_pid_success)
+            violation("hilo %d: %llu operaciones exitosas sobre PIDs muertos", t,
+                      (unsigned long long)workers[t].dead_pid_success);
+    }
+
+    ret = get_limits(buf, list_cap, &returned);
+    check_snapshot(buf, ret, returned, seen);
+    for (i = 0; i < opt_pool; i++)
+        listed += seen[i];
+    if (adds - removes != listed)
+        violation("adds - removes = %ld pero la lista tiene %ld PIDs del conjunto",
+                  adds - removes, listed);
+
+    // 559 busca en la tabla hash; 558 recorre la lista: deben coincidir
+    for (i = 0; i < opt_pool; i++) {
+        ret = syscall(NR_UPDATE_MEMORY_LIMIT, pool[i], LIMIT_BASE);
+        if ((ret == 0) != seen[i])
+            violation("PID %d: update retornó %d pero %s en la lista", pool[i],
+                      ret == 0 ? 0 : -errno, seen[i] ? "está" : "no está");
+        if (ret == 0 && syscall(NR_REMOVE_MEMORY_LIMIT, pool[i]) != 0)
+            violation("PID %d: no se pudo quitar: %s", pool[i], strerror(errno));
+    }
+
+    ret = get_limits(buf, list_cap, &returned);
+    check_snapshot(buf, ret, returned, seen);
+    for (i = 0; i < opt_pool; i++) {
+        if (seen[i])
+            violation("PID %d sigue en la lista después de quitarlo", pool[i]);
+    }
+    if (ret >= 0 && ret != nr_baseline)
+        violation("la lista final tiene %ld registros, al inicio tenía %d", ret, nr_baseline);
+
+    free(buf);
+    free(seen);
+}
+
+static void report(const struct worker *workers, uint64_t wall_ns)
+{
+    struct op_stats total[NR_OPS];
+    uint64_t all = 0;
+    unsigned int i;
+    int t, json = !strcmp(opt_format, "json");
+
+    memset(total, 0, sizeof(total));
+    for (i = 0; i < NR_OPS; i++)
+        hist_init(&total[i].hist);
+    for (t = 0; t < opt_threads; t++) {
+        for (i = 0; i < NR_OPS; i++) {
+            const struct op_stats *s = &workers[t].ops[i];
+
+            hist_merge(&total[i].hist, &s->hist);
+            total[i].ok += s->ok;
+            total[i].esrch += s->esrch;
+            total[i].registered += s->registered;
+            total[i].other += s->other;
+        }
+    }
+    for (i = 0; i < NR_OPS; i++)
+        all += total[i].hist.count;
+
+    if (json) {
+        printf("{\"threads\":%d,\"pool\":%ld,\"seconds\":%.2f,\"mix\":\"%u:%u:%u:%u\",\"invalid\":%.3f,"
+               "\"ops_per_sec\":%.0f,\"checks\":%llu,\"violations\":%llu,\"ops\":{",
+               opt_threads, opt_pool, wall_ns / 1e9, opt_mix[0], opt_mix[1], opt_mix[2], opt_mix[3],
+               opt_invalid, all * 1e9 / wall_ns, (unsigned long long)checks,
+               (unsigned long long)violations);
+        for (i = 0; i < NR_OPS; i++) {
+            printf("%s\"%s\":{\"count\":%llu,\"ok\":%llu,\"esrch\":%llu,\"registered\":%llu,\"other\":%llu,"
+                   "\"ops_per_sec\":%.0f,\"mean_ns\":%llu,\"p50_ns\":%llu,\"p99_ns\":%llu,\"max_ns\":%llu}",
+                   i ? "," : "", op_names[i],
+                   (unsigned long long)total[i].hist.count, (unsigned long long)total[i].ok,
+                   (unsigned long long)total[i].esrch, (unsigned long long)total[i].registered,
+                   (unsigned long long)total[i].other, total[i].hist.count * 1e9 / wall_ns,
+                   (unsigned long long)hist_mean(&total[i].hist),
+                   (unsigned long long)hist_percentile(&total[i].hist, 0.50),
+                   (unsigned long long)hist_percentile(&total[i].hist, 0.99),
+                   (unsigned long long)total[i].hist.max);
+        }
+        printf("}}\n");
+        return;
+    }
+
+    printf("hilos=%d procesos=%ld segundos=%.2f mezcla=%u:%u:%u:%u inválidos=%.1f%%\n",
+           opt_threads, opt_pool, wall_ns / 1e9, opt_mix[0], opt_mix[1], opt_mix[2], opt_mix[3],
+           opt_invalid * 100);
+    printf("%-8s %10s %10s %10s %10s %8s %10s %9s %9s %9s %10s\n", "op", "llamadas", "ok", "ESRCH",
+           "ya_reg", "otros", "ops/s", "media_ns", "p50_ns", "p99_ns", "max_ns");
+    for (i = 0; i < NR_OPS; i++) {
+        printf("%-8s %10llu %10llu %10llu %10llu %8llu %10.0f %9llu %9llu %9llu %10llu\n",
+               op_names[i], (unsigned long long)total[i].hist.count, (unsigned long long)total[i].ok,
+               (unsigned long long)total[i].esrch, (unsigned long long)total[i].registered,
+               (unsigned long long)total[i].other, total[i].hist.count * 1e9 / wall_ns,
+               (unsigned long long)hist_mean(&total[i].hist),
+               (unsigned long long)hist_percentile(&total[i].hist, 0.50),
+               (unsigned long long)hist_percentile(&total[i].hist, 0.99),
+               (unsigned long long)total[i].hist.max);
+    }
+    printf("total: %.0f ops/s, %llu verificaciones, %llu inconsistencias\n",
+           all * 1e9 / wall_ns, (unsigned long long)checks, (unsigned long long)violations);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Uso: %s [opciones]\n"
+            "  -t N        hilos de carga (%d)\n"
+            "  -p N        procesos del conjunto de prueba (%ld)\n"
+            "  -d N        duración en segundos (%d)\n"
+            "  -m A:U:R:G  pesos de add, update, remove y get (%u:%u:%u:%u)\n"
+            "  -x F        fracción de operaciones sobre PIDs muertos (%.2f)\n"
+            "  -i N        ms entre lecturas del verificador (%d)\n"
+            "  -f F        formato de salida: text o json (%s)\n",
+            prog, opt_threads, opt_pool, opt_seconds, opt_mix[0], opt_mix[1], opt_mix[2],
+            opt_mix[3], opt_invalid, opt_check_ms, opt_format);
+}
+
+int main(int argc, char *argv[])
+{
+    struct worker *workers;
+    pthread_t checker;
+    uint64_t start, wall;
+    unsigned int i;
+    int opt, t, returned;
+    long ret;
+
+    while ((opt = getopt(argc, argv, "t:p:d:m:x:i:f:h")) != -1) {
+        switch (opt) {
+        case 't': opt_threads = atoi(optarg); break;
+        case 'p': opt_pool = atol(optarg); break;
+        case 'd': opt_seconds = atoi(optarg); break;
+        case 'm':
+            if (sscanf(optarg, "%u:%u:%u:%u", &opt_mix[0], &opt_mix[1], &opt_mix[2], &opt_mix[3]) != 4) {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'x': opt_invalid = atof(optarg); break;
+        case 'i': opt_check_ms = atoi(optarg); break;
+        case 'f': opt_format = optarg; break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (opt_threads <= 0 || opt_pool <= 0 || opt_seconds <= 0 || opt_invalid < 0 || opt_invalid > 1 ||
+        opt_check_ms <= 0 || !(opt_mix[0] + opt_mix[1] + opt_mix[2] + opt_mix[3]) ||
+        (strcmp(opt_format, "text") && strcmp(opt_format, "json"))) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (geteuid() != 0) {
+        fprintf(stderr, "Se requiere root: 557, 559 y 560 necesitan CAP_SYS_ADMIN\n");
+        return 1;
+    }
+
+    pool = calloc(opt_pool, sizeof(*pool));
+    dead = calloc(64, sizeof(*dead));
+    workers = calloc(opt_threads, sizeof(*workers));
+    if (!pool || !dead || !workers) {
+        perror("calloc");
+        return 1;
+    }
+
+    // Registros que ya existían: se ignoran en las verificaciones
+    list_cap = 4096;
+    for (;;) {
+        baseline = realloc(baseline, list_cap * sizeof(*baseline));
+        if (!baseline) {
+            perror("realloc");
+            return 1;
+        }
+        ret = get_limits(baseline, list_cap, &returned);
+        if (ret < 0) {
+            perror("_202000173_get_memory_limits");
+            return 1;
+        }
+        if ((size_t)ret < list_cap)
+            break;
+        list_cap *= 2;
+    }
+    nr_baseline = ret;
+    list_cap = nr_baseline + opt_pool + 64;
+
+    spawn_pool();
+    for (t = 0; t < opt_threads; t++) {
+        workers[t].seed = 0x5eed + t;
+        for (i = 0; i < NR_OPS; i++)
+            hist_init(&workers[t].ops[i].hist);
+        workers[t].buf = calloc(list_cap, sizeof(*workers[t].buf));
+        if (!workers[t].buf) {
+            perror("calloc");
+            kill_pool();
+            return 1;
+        }
+    }
+
+    start = now_ns();
+    pthread_create(&checker, NULL, checker_fn, NULL);
+    for (t = 0; t < opt_threads; t++)
+        pthread_create(&workers[t].thread, NULL, worker_fn, &workers[t]);
+    sleep(opt_seconds);
+    stop = 1;
+    for (t = 0; t < opt_threads; t++)
+        pthread_join(workers[t].thread, NULL);
+    wall = now_ns() - start;
+    pthread_join(checker, NULL);
+
+    final_check(workers);
+    report(workers, wall);
+
+    kill_pool();
+    for (t = 0; t < opt_threads; t++)
+        free(workers[t].buf);
+    free(workers);
+    free(pool);
+    free(dead);
+    free(baseline);
+    return violations ? 2 : 0;
+}